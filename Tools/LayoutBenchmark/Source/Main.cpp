@@ -0,0 +1,366 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+ ==============================================================================
+
+ Main.cpp
+ Created: 16 Oct 2026 2:40:18pm
+
+ Runs synthetic layouts through the ff_layout module and prints the time per
+ operation. No window is opened, so it can run on a build machine.
+
+ Usage: LayoutBenchmark [--iterations N] [--scenario name]
+
+ ==============================================================================
+ */
+
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+#include <functional>
+#include <iostream>
+
+//==============================================================================
+/**
+ A generated layout definition together with the componentIDs, the owning
+ component has to provide as children.
+ */
+struct Scenario
+{
+    String      name;
+    String      xml;
+    StringArray componentIDs;
+    StringArray splitterIDs;
+};
+
+static String componentXml (Scenario& scenario, const String& extraAttributes = String())
+{
+    const String componentID ("c" + String (scenario.componentIDs.size()));
+    scenario.componentIDs.add (componentID);
+    return "<Component componentID=\"" + componentID + "\" " + extraAttributes + "/>\n";
+}
+
+static String splitterXml (Scenario& scenario, float position)
+{
+    const String splitterID ("s" + String (scenario.splitterIDs.size()));
+    scenario.splitterIDs.add (splitterID);
+    return "<Splitter componentID=\"" + splitterID + "\" relativePosition=\"" + String (position) + "\"/>\n";
+}
+
+/** Nested sub layouts with alternating orientation and a few items in each level */
+static Scenario createDeepScenario (int depth)
+{
+    Scenario scenario;
+    scenario.name = "deep";
+    String xml;
+    for (int level=0; level < depth; ++level) {
+        xml << "<Layout orientation=\"" << (level % 2 == 0 ? "leftToRight" : "topDown") << "\" paddingLeft=\"1\" paddingTop=\"1\">\n";
+        xml << componentXml (scenario, "minWidth=\"2\" minHeight=\"2\"");
+        xml << componentXml (scenario, "stretchX=\"0.5\" stretchY=\"0.5\"");
+    }
+    for (int level=0; level < depth; ++level) {
+        xml << "</Layout>\n";
+    }
+    scenario.xml = xml;
+    return scenario;
+}
+
+/** A single row with a lot of items */
+static Scenario createWideScenario (int numItems)
+{
+    Scenario scenario;
+    scenario.name = "wide";
+    String xml ("<Layout orientation=\"leftToRight\">\n");
+    for (int i=0; i < numItems; ++i) {
+        xml << componentXml (scenario, "stretchX=\"" + String (1 + i % 3) + "\" maxWidth=\"" + String (i % 7 == 0 ? 4 : -1) + "\"");
+    }
+    xml << "</Layout>\n";
+    scenario.xml = xml;
+    return scenario;
+}
+
+/** Columns separated by splitters, each column is a sub layout with some rows */
+static Scenario createSplitterScenario (int numSplitters)
+{
+    Scenario scenario;
+    scenario.name = "splitters";
+    String xml ("<Layout orientation=\"leftToRight\">\n");
+    for (int i=0; i <= numSplitters; ++i) {
+        if (i > 0) {
+            xml << splitterXml (scenario, static_cast<float>(i) / (numSplitters + 1));
+        }
+        xml << "<Layout orientation=\"topDown\" minWidth=\"2\">\n";
+        for (int j=0; j < 4; ++j) {
+            xml << componentXml (scenario, "minHeight=\"" + String (j) + "\"");
+        }
+        xml << "</Layout>\n";
+    }
+    xml << "</Layout>\n";
+    scenario.xml = xml;
+    return scenario;
+}
+
+/** Items covered by overlays referring to the previous item and to the parent */
+static Scenario createOverlayScenario (int numItems)
+{
+    Scenario scenario;
+    scenario.name = "overlays";
+    String xml ("<Layout orientation=\"topDown\">\n");
+    for (int i=0; i < numItems; ++i) {
+        xml << componentXml (scenario);
+        xml << componentXml (scenario, "overlay=\"" + String (i % 2 == 0 ? 1 : 2) + "\" overlayWidth=\"0.5\" overlayHeight=\"0.25\" overlayJustification=\"18\"");
+    }
+    xml << "</Layout>\n";
+    scenario.xml = xml;
+    return scenario;
+}
+
+/** A grid of items, that keep their aspect ratio inside size limits */
+static Scenario createAspectScenario (int numRows, int numColumns)
+{
+    Scenario scenario;
+    scenario.name = "aspect";
+    String xml ("<Layout orientation=\"topDown\">\n");
+    for (int row=0; row < numRows; ++row) {
+        xml << "<Layout orientation=\"leftToRight\">\n";
+        for (int column=0; column < numColumns; ++column) {
+            xml << componentXml (scenario, "aspectRatio=\"" + String (0.5 + 0.25 * (column % 4)) + "\" minWidth=\"4\" maxHeight=\"40\"");
+        }
+        xml << "</Layout>\n";
+    }
+    xml << "</Layout>\n";
+    scenario.xml = xml;
+    return scenario;
+}
+
+/** Labels created by the layout next to the components */
+static Scenario createLabelScenario (int numItems)
+{
+    Scenario scenario;
+    scenario.name = "labels";
+    String xml ("<Layout orientation=\"topDown\">\n");
+    for (int i=0; i < numItems; ++i) {
+        xml << "<Layout orientation=\"leftToRight\">\n";
+        xml << "<Component labelText=\"Label " << i << "\" labelJustification=\"34\" maxWidth=\"80\"/>\n";
+        xml << componentXml (scenario);
+        xml << "</Layout>\n";
+    }
+    xml << "</Layout>\n";
+    scenario.xml = xml;
+    return scenario;
+}
+
+//==============================================================================
+/**
+ A component with an empty child for each componentID of the scenario, which
+ hosts the layout.
+ */
+class BenchmarkComponent : public Component
+{
+public:
+    BenchmarkComponent (const Scenario& scenario)
+    : layout (LayoutItem::LeftToRight, this)
+    {
+        setSize (1600, 1200);
+        for (int i=0; i < scenario.componentIDs.size(); ++i) {
+            Component* child = new Component();
+            child->setComponentID (scenario.componentIDs [i]);
+            children.add (child);
+            addAndMakeVisible (child);
+        }
+    }
+
+    void loadLayout (const ValueTree& tree)
+    {
+        layout.state = tree;
+    }
+
+    Layout                  layout;
+    OwnedArray<Component>   children;
+};
+
+static ValueTree parseScenario (const Scenario& scenario)
+{
+    ScopedPointer<XmlElement> element = XmlDocument::parse (scenario.xml);
+    if (element) {
+        return ValueTree::fromXml (*element);
+    }
+    return ValueTree();
+}
+
+//==============================================================================
+
+/**
+ Runs operation the given number of times and returns the median time in microseconds.
+ The setup is called before each run and is not included in the time.
+ */
+static double measure (int iterations, std::function<void (int iteration)> setup, std::function<void (int iteration)> operation)
+{
+    Array<double> times;
+    for (int i=0; i < iterations; ++i) {
+        if (setup) {
+            setup (i);
+        }
+        const int64 start = Time::getHighResolutionTicks();
+        operation (i);
+        const int64 stop  = Time::getHighResolutionTicks();
+        times.add (Time::highResolutionTicksToSeconds (stop - start) * 1000000.0);
+    }
+    if (times.isEmpty()) {
+        return 0.0;
+    }
+    DefaultElementComparator<double> sorter;
+    times.sort (sorter);
+    return times [times.size() / 2];
+}
+
+static double measure (int iterations, std::function<void (int iteration)> operation)
+{
+    return measure (iterations, nullptr, operation);
+}
+
+static void printResult (const Scenario& scenario, const String& operation, int numItems, double micros)
+{
+    std::cout << scenario.name.paddedRight (' ', 12)
+              << operation.paddedRight (' ', 22)
+              << String (numItems).paddedLeft (' ', 8)
+              << String (micros, 1).paddedLeft (' ', 14) << " us" << std::endl;
+}
+
+static void runScenario (const Scenario& scenario, int iterations)
+{
+    const int numItems = scenario.componentIDs.size();
+
+    printResult (scenario, "parse xml", numItems, measure (iterations, [&scenario] (int) {
+        parseScenario (scenario);
+    }));
+
+    ScopedPointer<BenchmarkComponent> fresh;
+    printResult (scenario, "realize", numItems, measure (iterations, [&scenario, &fresh] (int) {
+        fresh = nullptr;
+        fresh = new BenchmarkComponent (scenario);
+        fresh->loadLayout (parseScenario (scenario));
+    },
+    [&fresh] (int) {
+        fresh->layout.realize();
+    }));
+    fresh = nullptr;
+
+    BenchmarkComponent owner (scenario);
+    owner.loadLayout (parseScenario (scenario));
+    owner.layout.realize();
+    owner.layout.updateGeometry();
+
+    printResult (scenario, "updateGeometry resize", numItems, measure (iterations, [&owner] (int i) {
+        // grow and shrink by one pixel, like a window being dragged
+        owner.setSize (1600 + (i % 2), 1200 + (i % 2));
+        owner.layout.updateGeometry();
+    }));
+
+    printResult (scenario, "updateGeometry same", numItems, measure (iterations, [&owner] (int) {
+        owner.layout.updateGeometry();
+    }));
+
+    if (scenario.splitterIDs.size() > 0) {
+        const String splitterID = scenario.splitterIDs [scenario.splitterIDs.size() / 2];
+        ValueTree splitterNode = owner.layout.getLayoutItem (splitterID);
+        LayoutSplitter splitter (splitterNode);
+        Component* splitterComponent = splitter.getComponent();
+        const float position = splitter.getRelativePosition();
+
+        printResult (scenario, "splitter drag", numItems, measure (iterations, [&] (int i) {
+            // the same steps as LayoutSplitter::Component::mouseDrag
+            ValueTree item = owner.layout.getLayoutItem (splitterComponent);
+            LayoutSplitter dragged (item);
+            dragged.setRelativePosition (position + (i % 2 == 0 ? 0.001f : -0.001f));
+            owner.layout.updateGeometry();
+        }));
+    }
+
+    if (numItems > 0) {
+        // the last item is the deepest in nested scenarios, its stretch feeds all
+        // sub layouts above without explicit stretch
+        ValueTree item = owner.layout.getLayoutItem (scenario.componentIDs [numItems - 1]);
+
+        printResult (scenario, "nested stretch", numItems, measure (iterations, [&] (int i) {
+            item.setProperty (LayoutItem::propStretchX, i % 2 == 0 ? 2.0 : 0.5, nullptr);
+            owner.layout.updateGeometry();
+        }));
+    }
+
+    const int numRemovals = jmin (iterations, numItems);
+    printResult (scenario, "removeComponent", numItems, measure (numRemovals, [&owner] (int i) {
+        owner.layout.removeComponent (owner.children [i]);
+    }));
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // components need the message manager, but no display
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    StringArray args;
+    for (int i=1; i < argc; ++i) {
+        args.add (argv[i]);
+    }
+
+    int iterations = 21;
+    const int iterationsIndex = args.indexOf ("--iterations");
+    if (iterationsIndex >= 0 && iterationsIndex + 1 < args.size()) {
+        iterations = jmax (1, args [iterationsIndex + 1].getIntValue());
+    }
+    String filter;
+    const int scenarioIndex = args.indexOf ("--scenario");
+    if (scenarioIndex >= 0 && scenarioIndex + 1 < args.size()) {
+        filter = args [scenarioIndex + 1];
+    }
+
+    Array<Scenario> scenarios;
+    scenarios.add (createDeepScenario (64));
+    scenarios.add (createWideScenario (2000));
+    scenarios.add (createSplitterScenario (200));
+    scenarios.add (createOverlayScenario (500));
+    scenarios.add (createAspectScenario (40, 25));
+    scenarios.add (createLabelScenario (500));
+
+    std::cout << String ("scenario").paddedRight (' ', 12)
+              << String ("operation").paddedRight (' ', 22)
+              << String ("items").paddedLeft (' ', 8)
+              << String ("median").paddedLeft (' ', 14) << std::endl;
+
+    for (int i=0; i < scenarios.size(); ++i) {
+        if (filter.isEmpty() || scenarios.getReference (i).name == filter) {
+            runScenario (scenarios.getReference (i), iterations);
+        }
+    }
+    return 0;
+}
@@ -70,6 +70,8 @@ PopupMenu EditorMenuBar::getMenuForIndex (int topLevelMenuIndex, const String& m
         menu.addCommandItem (cm, LayoutXMLEditor::CMDLayoutEditor_Open);
         menu.addCommandItem (cm, LayoutXMLEditor::CMDLayoutEditor_Save);
         menu.addCommandItem (cm, LayoutXMLEditor::CMDLayoutEditor_SaveAs);
+        menu.addSeparator();
+        menu.addCommandItem (cm, LayoutXMLEditor::CMDLayoutEditor_ExportBinary);
 #ifndef __APPLE__
         menu.addSeparator();
         menu.addCommandItem (cm, StandardApplicationCommandIDs::quit);
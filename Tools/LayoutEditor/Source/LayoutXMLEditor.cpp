@@ -119,6 +119,7 @@ void LayoutXMLEditor::getAllCommands (Array< CommandID > &commands)
     commands.add (CMDLayoutEditor_Open);
     commands.add (CMDLayoutEditor_Save);
     commands.add (CMDLayoutEditor_SaveAs);
+    commands.add (CMDLayoutEditor_ExportBinary);
     commands.add (StandardApplicationCommandIDs::del);
     commands.add (CMDLayoutEditor_Run);
     commands.add (CMDLayoutEditor_Refresh);
@@ -147,6 +148,9 @@ void LayoutXMLEditor::getCommandInfo (CommandID commandID, ApplicationCommandInf
             result.setInfo ("Save Layout as...", "Save the current layout XML definition under a new name", "File", 0);
             result.defaultKeypresses.add (KeyPress ('s', ModifierKeys::commandModifier | ModifierKeys::shiftModifier, 0));
             break;
+        case CMDLayoutEditor_ExportBinary:
+            result.setInfo ("Export binary layout...", "Save the current layout in the binary format for fast loading", "File", 0);
+            break;
         case StandardApplicationCommandIDs::del:
             result.setInfo ("Delete", "Delete the selected node", "Edit", 0);
             result.defaultKeypresses.add (KeyPress (KeyPress::deleteKey, 0, 0));
@@ -266,6 +270,35 @@ bool LayoutXMLEditor::perform (const InvocationInfo &info)
                 }
             }
             break;
+        case CMDLayoutEditor_ExportBinary:
+            {
+                WildcardFileFilter wildcardFilter ("*.layout", String::empty, "Binary layout file");
+                FileBrowserComponent browser (FileBrowserComponent::saveMode | FileBrowserComponent::canSelectFiles,
+                                              openedFile.existsAsFile() ? openedFile.withFileExtension ("layout") : File::nonexistent,
+                                              &wildcardFilter,
+                                              nullptr);
+                FileChooserDialogBox dialogBox ("Export binary layout",
+                                                "Please choose a file for the binary layout...",
+                                                browser,
+                                                false,
+                                                Colours::lightgrey);
+                if (dialogBox.show())
+                {
+                    DBG (String ("Export: ") + browser.getSelectedFile (0).getFileName());
+                    FileOutputStream output (browser.getSelectedFile (0));
+                    if (output.openedOk()) {
+                        output.setPosition (0);
+                        output.truncate();
+                        if (! LayoutBinaryFormat::convertFromXml (codeDocument->getAllContent(), output)) {
+                            AlertWindow::showMessageBoxAsync (AlertWindow::WarningIcon,
+                                                              TRANS ("Export failed"),
+                                                              TRANS ("The layout XML could not be parsed."));
+                        }
+                    }
+                    return true;
+                }
+            }
+            break;
         case CMDLayoutEditor_Run:
             if (!previewWindow) {
                 previewWindow = new PreviewComponent (TRANS ("Layout Preview"), Colours::darkgrey, DocumentWindow::allButtons);
@@ -412,6 +445,13 @@ void LayoutXMLEditor::getPropertiesForItem (const Identifier type, Array<Identif
         props.add (LayoutItem::propOverlayWidth);
         props.add (LayoutItem::propOverlayHeight);
         props.add (LayoutItem::propOverlayJustification);
+        props.add (LayoutItem::propVirtual);
+        props.add (LayoutItem::propGridColumns);
+        props.add (LayoutItem::propGridRows);
+        props.add (LayoutItem::propGridColumn);
+        props.add (LayoutItem::propGridRow);
+        props.add (LayoutItem::propGridColumnSpan);
+        props.add (LayoutItem::propGridRowSpan);
     }
     else if (type == LayoutItem::itemTypeComponent) {
         props.add (LayoutItem::propComponentName);
@@ -434,6 +474,10 @@ void LayoutXMLEditor::getPropertiesForItem (const Identifier type, Array<Identif
         props.add (LayoutItem::propOverlayWidth);
         props.add (LayoutItem::propOverlayHeight);
         props.add (LayoutItem::propOverlayJustification);
+        props.add (LayoutItem::propGridColumn);
+        props.add (LayoutItem::propGridRow);
+        props.add (LayoutItem::propGridColumnSpan);
+        props.add (LayoutItem::propGridRowSpan);
     }
     else if (type == LayoutItem::itemTypeSplitter) {
         props.add (LayoutSplitter::propComponentName);
@@ -481,7 +525,7 @@ void LayoutXMLEditor::updatePropertiesView (ValueTree state)
         if (propertyName == LayoutItem::propOrientation) {
             StringArray o;
             Array<var>  v;
-            for (int i=0; i<5; ++i) {
+            for (int i=0; i<=LayoutItem::FlowLayout; ++i) {
                 Identifier orientation = LayoutItem::getNameFromOrientation (LayoutItem::Orientation (i));
                 o.add (orientation.toString());
                 v.add (orientation.toString());
@@ -632,6 +676,9 @@ void LayoutXMLEditor::updateFromCodeDocument ()
 
 void LayoutXMLEditor::valueTreePropertyChanged (ValueTree &treeWhosePropertyHasChanged, const Identifier &property)
 {
+    if (LayoutItem::isTransientProperty (property)) {
+        return;
+    }
     codeDocument->replaceAllContent (documentContent.toXmlString());
     layoutTree->repaint();
     if (previewWindow) {
@@ -97,7 +97,8 @@ public:
         CMDLayoutEditor_InsertLayout,
         CMDLayoutEditor_InsertComponent,
         CMDLayoutEditor_InsertSplitter,
-        CMDLayoutEditor_InsertSpacer
+        CMDLayoutEditor_InsertSpacer,
+        CMDLayoutEditor_ExportBinary
     };
 
     // toolbar factory
@@ -67,14 +67,47 @@ const juce::Identifier Layout::settingsSplittersList("splittersList");
 const juce::Identifier Layout::settingsSplitterPos  ("splitterPos");
 
 Layout::Layout (LayoutItem::Orientation o, juce::Component* owner)
-: owningComponent (owner)
+: owningComponent (owner),
+  isApplyingPlan (false),
+  structureChangedWhileApplying (false),
+  structureChangedWhileSolving (false),
+  asynchronousUpdates (false),
+  lazyComponentCreation (false),
+  releaseCollapsedComponents (false),
+  solverPool (nullptr),
+  requestedGeneration (0),
+  stateVersion (0),
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+  isTracing (false),
+#endif
+  solutionCacheSize (4),
+  solutionCacheVersion (0),
+  childLookupOwner (nullptr)
 {
     state = LayoutItem (o).state;
+    state.addListener (this);
 }
 
 Layout::Layout (const juce::String& xml, juce::Component* owner)
-: owningComponent (owner)
+: owningComponent (owner),
+  isApplyingPlan (false),
+  structureChangedWhileApplying (false),
+  structureChangedWhileSolving (false),
+  asynchronousUpdates (false),
+  lazyComponentCreation (false),
+  releaseCollapsedComponents (false),
+  solverPool (nullptr),
+  requestedGeneration (0),
+  stateVersion (0),
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+  isTracing (false),
+#endif
+  solutionCacheSize (4),
+  solutionCacheVersion (0),
+  childLookupOwner (nullptr)
 {
+    state.addListener (this);
+
     juce::ScopedPointer<juce::XmlElement> mainElement = juce::XmlDocument::parse (xml);
     
     // loading of the xml failed. Probably the xml was malformed, so that ValueTree could not parse it.
@@ -87,15 +120,71 @@ Layout::Layout (const juce::String& xml, juce::Component* owner)
 }
 
 Layout::Layout (const juce::ValueTree& state_, juce::Component* owner)
-: owningComponent (owner)
+: owningComponent (owner),
+  isApplyingPlan (false),
+  structureChangedWhileApplying (false),
+  structureChangedWhileSolving (false),
+  asynchronousUpdates (false),
+  lazyComponentCreation (false),
+  releaseCollapsedComponents (false),
+  solverPool (nullptr),
+  requestedGeneration (0),
+  stateVersion (0),
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+  isTracing (false),
+#endif
+  solutionCacheSize (4),
+  solutionCacheVersion (0),
+  childLookupOwner (nullptr)
 {
     state = state_;
+    state.addListener (this);
     LayoutItem root (state);
     realize ();
 }
 
+Layout::Layout (const void* data, size_t dataSize, juce::Component* owner)
+: owningComponent (owner),
+  isApplyingPlan (false),
+  structureChangedWhileApplying (false),
+  structureChangedWhileSolving (false),
+  asynchronousUpdates (false),
+  lazyComponentCreation (false),
+  releaseCollapsedComponents (false),
+  solverPool (nullptr),
+  requestedGeneration (0),
+  stateVersion (0),
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+  isTracing (false),
+#endif
+  solutionCacheSize (4),
+  solutionCacheVersion (0),
+  childLookupOwner (nullptr)
+{
+    state.addListener (this);
+
+    if (LayoutBinaryFormat::isBinaryLayout (data, dataSize)) {
+        state = LayoutBinaryFormat::read (data, dataSize);
+    }
+    else {
+        juce::ScopedPointer<juce::XmlElement> mainElement = juce::XmlDocument::parse (juce::String::fromUTF8 (static_cast<const char*> (data), static_cast<int> (dataSize)));
+        if (mainElement) {
+            state = juce::ValueTree::fromXml (*mainElement);
+        }
+    }
+
+    // loading failed. Either the xml was malformed or the binary layout was written by a newer version
+    jassert (state.isValid());
+
+    if (state.isValid()) {
+        realize ();
+    }
+}
+
 Layout::~Layout ()
 {
+    stopBackgroundSolve();
+    state.removeListener (this);
     masterReference.clear();
 }
 
@@ -119,7 +208,85 @@ void Layout::removeComponent (juce::Component* component)
 
 juce::ValueTree Layout::getLayoutItem (juce::Component* component)
 {
-    return LayoutItem::getLayoutItem (state, component);
+    if (component == nullptr) {
+        return juce::ValueTree();
+    }
+    juce::ValueTree node = componentIndex [component];
+    if (node.isValid() && (node == state || node.isAChildOf (state)) && LayoutItem (node).getComponent() == component) {
+        return node;
+    }
+    // components are connected without notifying the state, so they might not be indexed yet
+    node = LayoutItem::getLayoutItem (state, component);
+    if (node.isValid()) {
+        componentIndex.set (component, node);
+    }
+    return node;
+}
+
+juce::ValueTree Layout::getLayoutItem (const juce::String& componentID)
+{
+    if (componentID.isEmpty()) {
+        return juce::ValueTree();
+    }
+    juce::ValueTree node = componentIDIndex [componentID];
+    if (node.isValid() && (node == state || node.isAChildOf (state)) && node.getProperty (LayoutItem::propComponentID) == componentID) {
+        return node;
+    }
+    juce::String lookupID (componentID);
+    node = LayoutItem::getLayoutItem (state, lookupID);
+    if (node.isValid()) {
+        componentIDIndex.set (componentID, node);
+    }
+    return node;
+}
+
+void Layout::addComponentToIndex (const juce::ValueTree& node, juce::Component* component)
+{
+    if (component != nullptr) {
+        componentIndex.set (component, node);
+    }
+}
+
+void Layout::removeComponentFromIndex (const juce::ValueTree& node, juce::Component* component)
+{
+    if (component != nullptr && componentIndex [component] == node) {
+        componentIndex.remove (component);
+    }
+}
+
+void Layout::addToIndex (const juce::ValueTree& node)
+{
+    LayoutItem item (node);
+    addComponentToIndex (node, item.getComponent());
+    const juce::String componentID = node.getProperty (LayoutItem::propComponentID).toString();
+    if (componentID.isNotEmpty()) {
+        componentIDIndex.set (componentID, node);
+    }
+    for (int i=0; i < node.getNumChildren(); ++i) {
+        addToIndex (node.getChild (i));
+    }
+}
+
+void Layout::removeFromIndex (const juce::ValueTree& node)
+{
+    LayoutItem item (node);
+    removeComponentFromIndex (node, item.getComponent());
+    const juce::String componentID = node.getProperty (LayoutItem::propComponentID).toString();
+    if (componentID.isNotEmpty() && componentIDIndex [componentID] == node) {
+        componentIDIndex.remove (componentID);
+    }
+    for (int i=0; i < node.getNumChildren(); ++i) {
+        removeFromIndex (node.getChild (i));
+    }
+}
+
+void Layout::rebuildIndex ()
+{
+    componentIndex.clear();
+    componentIDIndex.clear();
+    if (state.isValid()) {
+        addToIndex (state);
+    }
 }
 
 void Layout::clearLayout (juce::UndoManager* undo)
@@ -130,6 +297,9 @@ void Layout::clearLayout (juce::UndoManager* undo)
 
 void Layout::setSettingsTree (juce::ValueTree settings)
 {
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    const LayoutTraceRecorder::ScopedSpan settingsSpan (getTraceRecorder(), state, "settings");
+#endif
     currentSettings = settings;
     if (currentSettings.isValid()) {
         if (owningComponent) {
@@ -144,7 +314,7 @@ void Layout::setSettingsTree (juce::ValueTree settings)
                 juce::ValueTree node = splitters.getChild (i);
                 if (node.hasProperty (settingsSplitterPos)) {
                     juce::String splitterID = node.getType().toString();
-                    juce::ValueTree layoutItemNode = LayoutItem::getLayoutItem (state, splitterID);
+                    juce::ValueTree layoutItemNode = getLayoutItem (splitterID);
                     if (layoutItemNode.isValid() && layoutItemNode.getType() == LayoutItem::itemTypeSplitter) {
                         LayoutSplitter splitter (layoutItemNode);
                         splitter.setRelativePosition (node.getProperty (settingsSplitterPos));
@@ -182,6 +352,8 @@ void Layout::layoutSplitterMoved (juce::ValueTree item, float relativePos, bool
 void Layout::realize (juce::Component* owningComponent_)
 {
     LayoutItem root (state);
+    ++stateVersion;
+    clearPlan();
     
     root.addListener (this);
 
@@ -207,17 +379,311 @@ void Layout::realize (juce::Component* owningComponent_)
         resizeConstraints->setBoundsForComponent (owningComponent, newBounds, false, false, true, true);
         
     }
+    if (owningComponent) {
+        childLookupOwner = owningComponent;
+        for (int i=0; i < owningComponent->getNumChildComponents(); ++i) {
+            addChildToLookup (owningComponent, owningComponent->getChildComponent (i));
+        }
+    }
+
+    plan.setLazyComponentOwner (owningComponent, this, releaseCollapsedComponents);
     root.realize (state, owningComponent, this);
+
+    childLookupOwner = nullptr;
+    childrenByID.clear();
+    childrenByName.clear();
+
+    rebuildIndex();
+}
+
+juce::Component* Layout::findChildWithID (juce::Component* owner, const juce::String& componentID) const
+{
+    if (owner == nullptr) {
+        return nullptr;
+    }
+    if (owner == childLookupOwner) {
+        return childrenByID [componentID];
+    }
+    return owner->findChildWithID (componentID);
+}
+
+juce::Component* Layout::findChildWithName (juce::Component* owner, const juce::String& name) const
+{
+    if (owner == nullptr) {
+        return nullptr;
+    }
+    if (owner == childLookupOwner) {
+        return childrenByName [name];
+    }
+    for (int i=0; i < owner->getNumChildComponents(); ++i) {
+        juce::Component* child = owner->getChildComponent (i);
+        if (child->getName() == name) {
+            return child;
+        }
+    }
+    return nullptr;
+}
+
+void Layout::addChildToLookup (juce::Component* owner, juce::Component* child)
+{
+    if (owner == nullptr || owner != childLookupOwner || child == nullptr) {
+        return;
+    }
+    // the first child wins, like in a linear search
+    const juce::String componentID = child->getComponentID();
+    if (componentID.isNotEmpty() && ! childrenByID.contains (componentID)) {
+        childrenByID.set (componentID, child);
+    }
+    const juce::String name = child->getName();
+    if (! childrenByName.contains (name)) {
+        childrenByName.set (name, child);
+    }
 }
 
 void Layout::updateGeometry ()
 {
+    // a component resized by this layout must not trigger another update of it
+    if (isApplyingPlan) {
+        return;
+    }
+
+    if (asynchronousUpdates) {
+        triggerAsyncUpdate();
+    }
+    else {
+        updateGeometryNow();
+    }
+}
+
+void Layout::setAsynchronousUpdates (bool shouldUpdateAsynchronously)
+{
+    asynchronousUpdates = shouldUpdateAsynchronously;
+    if (! asynchronousUpdates) {
+        handleUpdateNowIfNeeded();
+    }
+}
+
+void Layout::setLazyComponentCreation (bool shouldCreateLazily, bool releaseCollapsed)
+{
+    lazyComponentCreation      = shouldCreateLazily;
+    releaseCollapsedComponents = shouldCreateLazily && releaseCollapsed;
+    stopBackgroundSolve();
+    plan.setLazyComponentOwner (owningComponent, this, releaseCollapsedComponents);
+}
+
+bool Layout::isCreatingComponentsLazily () const
+{
+    return lazyComponentCreation;
+}
+
+void Layout::setVisibleArea (juce::Rectangle<int> area)
+{
+    if (plan.getVisibleArea() == area) {
+        return;
+    }
+    stopBackgroundSolve();
+    plan.setVisibleArea (area);
+    if (plan.hasChanges()) {
+        updateGeometry();
+    }
+}
+
+juce::Rectangle<int> Layout::getVisibleArea () const
+{
+    return plan.getVisibleArea();
+}
+
+void Layout::setIntegerDistribution (bool shouldDistributeIntegers)
+{
+    if (plan.isDistributingIntegers() == shouldDistributeIntegers) {
+        return;
+    }
+    // cached solutions were rounded the other way
+    ++stateVersion;
+    stopBackgroundSolve();
+    plan.setIntegerDistribution (shouldDistributeIntegers);
+    updateGeometry();
+}
+
+bool Layout::isDistributingIntegers () const
+{
+    return plan.isDistributingIntegers();
+}
+
+LayoutNodeStats Layout::getNodeStats (const juce::ValueTree& node)
+{
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    if (! state.isValid()) {
+        return LayoutNodeStats();
+    }
+    stopBackgroundSolve();
+    compilePlan();
+    return getNodeStats (plan.indexOf (node));
+#else
+    juce::ignoreUnused (node);
+    return LayoutNodeStats();
+#endif
+}
+
+void Layout::resetInstrumentation ()
+{
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    stopBackgroundSolve();
+    plan.resetNodeStats();
+    realizedNodes.clear();
+    realizeStats.clear();
+#endif
+}
+
+void Layout::startTracing ()
+{
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    if (traceRecorder == nullptr) {
+        traceRecorder = std::unique_ptr<LayoutTraceRecorder> (new LayoutTraceRecorder());
+    }
+    traceRecorder->clear();
+    isTracing = true;
+    plan.setTraceRecorder (traceRecorder.get());
+#endif
+}
+
+void Layout::stopTracing ()
+{
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    isTracing = false;
+    plan.setTraceRecorder (nullptr);
+#endif
+}
+
+bool Layout::writeTrace (juce::OutputStream& stream) const
+{
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    if (traceRecorder != nullptr && traceRecorder->getNumSpans() > 0) {
+        traceRecorder->writeTo (stream);
+        return true;
+    }
+#else
+    juce::ignoreUnused (stream);
+#endif
+    return false;
+}
+
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+LayoutTraceRecorder* Layout::getTraceRecorder () const
+{
+    return isTracing ? traceRecorder.get() : nullptr;
+}
+
+LayoutNodeStats& Layout::getRealizeStats (const juce::ValueTree& node)
+{
+    const int i = realizedNodes.indexOf (node);
+    if (i >= 0) {
+        return *realizeStats.getUnchecked (i);
+    }
+    // the stats are owned, so the references of realizing parents stay valid
+    realizedNodes.add (node);
+    return *realizeStats.add (new LayoutNodeStats());
+}
+
+LayoutNodeStats Layout::getNodeStats (int index) const
+{
+    LayoutNodeStats stats = plan.getNodeStats (index);
+    if (juce::isPositiveAndBelow (index, plan.getNumItems())) {
+        const int i = realizedNodes.indexOf (plan.getNode (index));
+        if (i >= 0) {
+            stats.numRealizes  = realizeStats.getUnchecked (i)->numRealizes;
+            stats.realizeTicks = realizeStats.getUnchecked (i)->realizeTicks;
+        }
+    }
+    return stats;
+}
+#endif
+
+juce::String Layout::createInstrumentationReport (int maxNumItems)
+{
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    if (! state.isValid()) {
+        return juce::String();
+    }
+    stopBackgroundSolve();
+    compilePlan();
+
+    juce::Array<int> order;
+    for (int index=0; index < plan.getNumItems(); ++index) {
+        order.add (index);
+    }
+    const LayoutPlan& measured = plan;
+    std::stable_sort (order.begin(), order.end(), [&measured] (int a, int b)
+                      {
+                          return measured.getNodeStats (a).exclusiveTicks > measured.getNodeStats (b).exclusiveTicks;
+                      });
+
+    juce::String report ("index\titem\tsolves\tinclusive ms\texclusive ms\tsetBounds\tlisteners\tproperty updates\trealizes\trealize ms\n");
+    for (int i=0; i < juce::jmin (maxNumItems, order.size()); ++i) {
+        const int index = order.getUnchecked (i);
+        const juce::ValueTree node = plan.getNode (index);
+        const LayoutNodeStats stats = getNodeStats (index);
+        juce::String name = node.getType().toString();
+        const juce::String componentID = node.getProperty (LayoutItem::propComponentID).toString();
+        if (componentID.isNotEmpty()) {
+            name << " " << componentID;
+        }
+        report << index << "\t" << name
+               << "\t" << stats.numSolves
+               << "\t" << juce::String (stats.getInclusiveSeconds() * 1000.0, 3)
+               << "\t" << juce::String (stats.getExclusiveSeconds() * 1000.0, 3)
+               << "\t" << stats.numSetBounds
+               << "\t" << stats.numListenerCalls
+               << "\t" << stats.numPropertyUpdates
+               << "\t" << stats.numRealizes
+               << "\t" << juce::String (stats.getRealizeSeconds() * 1000.0, 3) << "\n";
+    }
+    return report;
+#else
+    juce::ignoreUnused (maxNumItems);
+    return "Compile with FF_LAYOUT_ENABLE_INSTRUMENTATION=1 to collect layout statistics\n";
+#endif
+}
+
+int Layout::getVirtualContentSize ()
+{
+    if (! state.isValid()) {
+        return 0;
+    }
+    stopBackgroundSolve();
+    compilePlan();
+    const int size = plan.getVirtualContentSize (0);
+    if (size <= 0) {
+        return 0;
+    }
+    LayoutItem root (state);
+    if (root.isHorizontal()) {
+        return size + root.getPaddingLeft() + root.getPaddingRight();
+    }
+    return size + root.getPaddingTop() + root.getPaddingBottom();
+}
+
+void Layout::handleAsyncUpdate ()
+{
+    updateGeometryNow();
+}
+
+void Layout::updateGeometryNow ()
+{
+    if (isApplyingPlan) {
+        return;
+    }
+
     if (state.isValid()) {
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+        const LayoutTraceRecorder::ScopedSpan updateSpan (getTraceRecorder(), state, "update");
+#endif
         LayoutItem root (state);
         juce::Rectangle<int> bounds = root.getItemBounds();
         if (bounds.isEmpty() && owningComponent) {
             bounds = owningComponent->getLocalBounds();
         }
+        rootBounds = bounds;
         if (!bounds.isEmpty()) {
             const int shrinkX = root.getPaddingLeft() + root.getPaddingRight();
             const int shrinkY = root.getPaddingTop() + root.getPaddingBottom();
@@ -226,19 +692,410 @@ void Layout::updateGeometry ()
                                              bounds.getY() + root.getPaddingRight(),
                                              bounds.getWidth() - shrinkX,
                                              bounds.getHeight() - shrinkY);
-                LayoutItem::updateGeometry (state, padded);
+                if (solverPool != nullptr) {
+                    requestedBounds = padded;
+                    ++requestedGeneration;
+                    // a running solve is finished first, it starts the next one when it's outdated
+                    if (backgroundSolver == nullptr) {
+                        compilePlan();
+                        if (restoreCachedSolution (padded)) {
+                            applyPlan (false);
+                        }
+                        else {
+                            startBackgroundSolve();
+                        }
+                    }
+                }
+                else {
+                    compilePlan();
+                    // only sub layouts with changed items are solved again, if the bounds didn't change
+                    if (restoreCachedSolution (padded)) {
+                        applyPlan (false);
+                    }
+                    else if (plan.solveChanges (padded)) {
+                        applyPlan (true);
+                    }
+                }
             }
             if (resizer) {
                 resizer->setBounds(bounds.getRight() - resizer->getWidth(), bounds.getBottom() - resizer->getHeight(), resizer->getWidth(), resizer->getHeight());
             }
-            root.callListenersCallback (bounds);
+            if (solverPool == nullptr) {
+                callRootListeners();
+            }
+        }
+    }
+}
+
+void Layout::callRootListeners ()
+{
+    if (rootListenerBounds != rootBounds) {
+        rootListenerBounds = rootBounds;
+        LayoutItem root (state);
+        root.callListenersCallback (rootBounds);
+    }
+}
+
+void Layout::callSplitterListenersAfterUpdate (const juce::ValueTree& splitter)
+{
+    if (asynchronousUpdates || solverPool != nullptr) {
+        splittersToReport.addIfNotAlreadyThere (splitter);
+        return;
+    }
+    // the synchronous update clamped the position already
+    juce::ValueTree node (splitter);
+    LayoutSplitter moved (node);
+    moved.callListenersCallback (moved.getRelativePosition(), false);
+}
+
+//==============================================================================
+/**
+ Solves the plan on a ThreadPool thread. The Layout moves its plan in and takes it
+ back on the message thread, when the job is done.
+ */
+class Layout::BackgroundSolver : public juce::ThreadPoolJob,
+                                 private juce::AsyncUpdater
+{
+public:
+    BackgroundSolver (Layout& owner_, LayoutPlan&& plan_, juce::Rectangle<int> bounds_, int generation_, int version_)
+    : juce::ThreadPoolJob ("Layout solver"),
+      owner (owner_),
+      plan (std::move (plan_)),
+      bounds (bounds_),
+      generation (generation_),
+      version (version_),
+      hasChanges (false)
+    {
+    }
+
+    JobStatus runJob () override
+    {
+        hasChanges = plan.solveChanges (bounds);
+        triggerAsyncUpdate();
+        return jobHasFinished;
+    }
+
+    void handleAsyncUpdate () override
+    {
+        owner.backgroundSolveFinished();
+    }
+
+    Layout&                 owner;
+    LayoutPlan              plan;
+    juce::Rectangle<int>    bounds;
+    const int               generation;
+    const int               version;
+    bool                    hasChanges;
+
+    JUCE_DECLARE_NON_COPYABLE (BackgroundSolver)
+};
+
+void Layout::setBackgroundSolving (juce::ThreadPool* pool)
+{
+    stopBackgroundSolve();
+    solverPool = pool;
+}
+
+void Layout::startBackgroundSolve ()
+{
+    compilePlan();
+    structureChangedWhileSolving = false;
+    backgroundSolver = std::unique_ptr<BackgroundSolver> (new BackgroundSolver (*this, std::move (plan), requestedBounds, requestedGeneration, stateVersion));
+    // the moved from plan keeps only the settings
+    plan.clear();
+    solverPool->addJob (backgroundSolver.get(), false);
+}
+
+void Layout::stopBackgroundSolve ()
+{
+    if (backgroundSolver != nullptr) {
+        std::unique_ptr<BackgroundSolver> stopped (std::move (backgroundSolver));
+        solverPool->removeJob (stopped.get(), false, -1);
+        takePlanFrom (*stopped);
+        // a result, that was solved already, is applied with the next update
+        triggerAsyncUpdate();
+    }
+}
+
+void Layout::backgroundSolveFinished ()
+{
+    // the job triggers the update just before it returns, so wait until the pool let it go
+    std::unique_ptr<BackgroundSolver> finished (std::move (backgroundSolver));
+    solverPool->removeJob (finished.get(), false, -1);
+    takePlanFrom (*finished);
+
+    if (finished->generation != requestedGeneration || finished->version != stateVersion) {
+        // the result is outdated by a newer resize or a change of the state. The plan
+        // keeps the solved items, so the next solve computes only the changes since
+        startBackgroundSolve();
+        return;
+    }
+
+    if (finished->hasChanges) {
+        applyPlan (true);
+    }
+}
+
+void Layout::takePlanFrom (BackgroundSolver& finished)
+{
+    if (structureChangedWhileSolving) {
+        // the state has to be compiled again anyway
+        structureChangedWhileSolving = false;
+    }
+    else {
+        plan = std::move (finished.plan);
+    }
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    // tracing may have been started or stopped while the job had the plan
+    plan.setTraceRecorder (getTraceRecorder());
+#endif
+    updatePlanForQueuedChanges();
+}
+
+void Layout::flush ()
+{
+    handleUpdateNowIfNeeded();
+    // an outdated result starts the next solve, so wait until a current one was applied
+    while (backgroundSolver != nullptr) {
+        solverPool->waitForJobToFinish (backgroundSolver.get(), -1);
+        backgroundSolveFinished();
+    }
+}
+
+//==============================================================================
+
+void Layout::setSolutionCacheSize (int numSolutions)
+{
+    solutionCacheSize = juce::jmax (0, numSolutions);
+    while (solutionCache.size() > solutionCacheSize) {
+        solutionCache.remove (0);
+    }
+}
+
+void Layout::compilePlan ()
+{
+    if (!plan.isCompiled() || plan.getNode (0) != state) {
+        plan.compile (state, true);
+        // the solutions refer to the indices of the previous plan
+        solutionCache.clear();
+    }
+}
+
+void Layout::applyPlan (bool storeSolution)
+{
+    bool positionsChanged;
+    {
+        const juce::ScopedValueSetter<bool> applying (isApplyingPlan, true);
+        positionsChanged = plan.apply ();
+        callRootListeners();
+    }
+    if (positionsChanged) {
+        // clamped splitters changed the state, so older solutions are outdated
+        ++stateVersion;
+    }
+
+    // the solution doesn't reflect changes made while it was applied, so don't keep it
+    const bool changedWhileApplying = structureChangedWhileApplying || ! queuedPropertyChanges.isEmpty();
+    if (changedWhileApplying) {
+        if (structureChangedWhileApplying) {
+            structureChangedWhileApplying = false;
+            clearPlan();
+        }
+        updatePlanForQueuedChanges();
+        // updateGeometry is locked while applying, so solve these changes on the next message
+        triggerAsyncUpdate();
+    }
+
+    // the splitters have their clamped positions now
+    juce::Array<juce::ValueTree> splitters;
+    splitters.swapWith (splittersToReport);
+    for (int i=0; i < splitters.size(); ++i) {
+        LayoutSplitter splitter (splitters.getReference (i));
+        splitter.callListenersCallback (splitter.getRelativePosition(), false);
+    }
+
+    if (storeSolution && ! changedWhileApplying && solutionCacheSize > 0 && ! plan.hasVirtualItems()) {
+        if (solutionCacheVersion != stateVersion) {
+            solutionCache.clear();
+            solutionCacheVersion = stateVersion;
+        }
+        LayoutPlan::Solution* solution = nullptr;
+        for (int i=0; i < solutionCache.size(); ++i) {
+            if (solutionCache.getUnchecked (i)->bounds == plan.getSolvedBounds()) {
+                solution = solutionCache.removeAndReturn (i);
+                break;
+            }
+        }
+        if (solution == nullptr) {
+            solution = new LayoutPlan::Solution();
+        }
+        plan.getSolution (*solution);
+        // the most recently used solution is kept at the end
+        solutionCache.add (solution);
+        while (solutionCache.size() > solutionCacheSize) {
+            solutionCache.remove (0);
+        }
+    }
+}
+
+bool Layout::restoreCachedSolution (juce::Rectangle<int> bounds)
+{
+    // solutions of virtual layouts depend on the visible area as well
+    if (solutionCacheVersion != stateVersion || ! plan.needsSolve (bounds) || plan.hasChanges() || plan.hasVirtualItems()) {
+        return false;
+    }
+    for (int i=0; i < solutionCache.size(); ++i) {
+        if (solutionCache.getUnchecked (i)->bounds == bounds) {
+            solutionCache.move (i, -1);
+            plan.restoreSolution (*solutionCache.getLast());
+            return true;
+        }
+    }
+    return false;
+}
+
+//==============================================================================
+
+void Layout::valueTreePropertyChanged (juce::ValueTree& tree, const juce::Identifier& property)
+{
+    if (LayoutItem::isTransientProperty (property)) {
+        // an item got data for listeners or a component, that the plan has to use
+        if (isApplyingPlan || backgroundSolver != nullptr) {
+            queuedPropertyChanges.add (std::make_pair (tree, property));
+        }
+        else {
+            updatePlanForProperty (tree, property);
+        }
+        return;
+    }
+    if (isApplyingPlan) {
+        // the plan writes the clamped splitter positions back, that is no change of the model
+        if (property == LayoutSplitter::propRelativePosition) {
+            const int index = plan.indexOf (tree);
+            if (index >= 0 && static_cast<float>(tree.getProperty (property)) == plan.getRelativePosition (index)) {
+                return;
+            }
         }
+        // a listener or a resized callback changed the model, the plan is still in use, so update it afterwards
+        ++stateVersion;
+        queuedPropertyChanges.add (std::make_pair (tree, property));
+        return;
+    }
+    ++stateVersion;
+    if (backgroundSolver != nullptr) {
+        // the job has the plan, it is updated when it comes back
+        queuedPropertyChanges.add (std::make_pair (tree, property));
+        return;
+    }
+    updatePlanForProperty (tree, property);
+}
+
+void Layout::updatePlanForQueuedChanges ()
+{
+    for (int i=0; i < queuedPropertyChanges.size(); ++i) {
+        std::pair<juce::ValueTree, juce::Identifier>& change = queuedPropertyChanges.getReference (i);
+        updatePlanForProperty (change.first, change.second);
+    }
+    queuedPropertyChanges.clear();
+}
+
+void Layout::updatePlanForProperty (juce::ValueTree& tree, const juce::Identifier& property)
+{
+    if (LayoutItem::isTransientProperty (property)) {
+        plan.updateSharedData (tree);
+        // a result solved in the background still refers to the previous data
+        ++stateVersion;
+        return;
+    }
+    if (property == LayoutItem::propComponentID) {
+        // the entry of the old ID is outdated now and will be skipped when looked up
+        const juce::String componentID = tree.getProperty (property).toString();
+        if (componentID.isNotEmpty()) {
+            componentIDIndex.set (componentID, tree);
+        }
+    }
+    // a changed property doesn't change the structure, so only that item is read again
+    if (! plan.updateProperties (tree, property)) {
+        plan.clear();
+    }
+}
+
+void Layout::valueTreeChildAdded (juce::ValueTree& parent, juce::ValueTree& child)
+{
+    ++stateVersion;
+    clearPlan();
+    addToIndex (child);
+}
+
+void Layout::valueTreeChildRemoved (juce::ValueTree& parent, juce::ValueTree& child, int index)
+{
+    ++stateVersion;
+    clearPlan();
+    removeFromIndex (child);
+}
+
+void Layout::valueTreeChildOrderChanged (juce::ValueTree& parent, int oldIndex, int newIndex)
+{
+    ++stateVersion;
+    clearPlan();
+}
+
+void Layout::valueTreeParentChanged (juce::ValueTree& tree)
+{
+    ++stateVersion;
+    clearPlan();
+}
+
+void Layout::clearPlan ()
+{
+    if (isApplyingPlan) {
+        // apply still loops over the plan, it is cleared when apply returned
+        structureChangedWhileApplying = true;
+        return;
+    }
+    plan.clear();
+    if (backgroundSolver != nullptr) {
+        // the plan of the job refers to the old structure
+        structureChangedWhileSolving = true;
     }
 }
 
 void Layout::paintBounds (juce::Graphics& g) const
 {
-    LayoutItem::paintBounds (state, g);
+    // only items with listeners or components keep their bounds, the plan has all of them.
+    // While a job solves the plan, the applied bounds can still be read from it
+    const LayoutPlan& applied = backgroundSolver != nullptr ? backgroundSolver->plan : plan;
+    for (int index=1; index < applied.getNumItems(); ++index) {
+        const juce::ValueTree node = applied.getNode (index);
+        const LayoutItem parent (node.getParent());
+        if (parent.isHorizontal()) {
+            g.setColour (juce::Colours::red);
+        }
+        else if (parent.isVertical()) {
+            g.setColour (juce::Colours::green);
+        }
+        else {
+            g.setColour (juce::Colours::grey);
+        }
+        const juce::Rectangle<int> bounds = applied.getAppliedBounds (index);
+        if (node.getType() == LayoutItem::itemTypeSubLayout) {
+            if (!bounds.isEmpty())
+                g.drawRect (bounds);
+        }
+        else {
+            g.drawRect (bounds.reduced(1));
+        }
+    }
+}
+
+juce::Rectangle<int> Layout::getItemBounds (const juce::ValueTree& node) const
+{
+    const LayoutPlan& applied = backgroundSolver != nullptr ? backgroundSolver->plan : plan;
+    const int index = applied.indexOf (node);
+    if (index < 0) {
+        return LayoutItem (node).getItemBounds();
+    }
+    return applied.getAppliedBounds (index);
 }
 
 //==============================================================================
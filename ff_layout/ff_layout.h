@@ -81,6 +81,24 @@
  
  */
 
+//==============================================================================
+/** Config: FF_LAYOUT_ENABLE_INSTRUMENTATION
+    Collects counters and timings for each layout item, e.g. how often it was solved and how
+    long that took, to find the sub layouts making a resize slow. Query them with
+    Layout::getNodeStats or Layout::createInstrumentationReport. It also enables recording
+    Chrome trace files with Layout::startTracing. Disabled by default, then nothing is
+    recorded at all.
+*/
+#ifndef FF_LAYOUT_ENABLE_INSTRUMENTATION
+ #define FF_LAYOUT_ENABLE_INSTRUMENTATION 0
+#endif
 
-#include "ff_layoutCore.h"
+
+#include "ff_layoutInstrumentation.h"
 #include "ff_layoutItem.h"
+#include "ff_layoutDistribution.h"
+#include "ff_layoutPlan.h"
+#include "ff_layoutCore.h"
+#include "ff_layoutBinaryFormat.h"
+#include "ff_layoutStatic.h"
+#include "ff_layoutViewport.h"
@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutBinaryFormat.cpp
+    Created: 16 Oct 2026 4:05:12pm
+
+  ==============================================================================
+*/
+
+
+#include "ff_layout.h"
+
+// "ffLB" in little endian
+const juce::uint32 LayoutBinaryFormat::magicNumber = 0x424c6666;
+const int LayoutBinaryFormat::formatVersion        = 1;
+
+bool LayoutBinaryFormat::isBinaryLayout (const void* data, size_t size)
+{
+    return data != nullptr && size >= 8 && juce::ByteOrder::littleEndianInt (data) == magicNumber;
+}
+
+bool LayoutBinaryFormat::write (const juce::ValueTree& tree, juce::OutputStream& out)
+{
+    if (! tree.isValid()) {
+        return false;
+    }
+    out.writeInt (static_cast<int> (magicNumber));
+    out.writeInt (formatVersion);
+    createTypedCopy (tree).writeToStream (out);
+    return true;
+}
+
+juce::ValueTree LayoutBinaryFormat::read (juce::InputStream& in)
+{
+    if (static_cast<juce::uint32> (in.readInt()) != magicNumber) {
+        return juce::ValueTree();
+    }
+    const int version = in.readInt();
+    if (version < 1 || version > formatVersion) {
+        // written by a newer version of the module
+        jassertfalse;
+        return juce::ValueTree();
+    }
+    return juce::ValueTree::readFromStream (in);
+}
+
+juce::ValueTree LayoutBinaryFormat::read (const void* data, size_t size)
+{
+    if (! isBinaryLayout (data, size)) {
+        return juce::ValueTree();
+    }
+    juce::MemoryInputStream in (data, size, false);
+    return read (in);
+}
+
+bool LayoutBinaryFormat::convertFromXml (const juce::String& xml, juce::OutputStream& out)
+{
+    juce::ScopedPointer<juce::XmlElement> element = juce::XmlDocument::parse (xml);
+    if (element) {
+        return write (juce::ValueTree::fromXml (*element), out);
+    }
+    return false;
+}
+
+juce::ValueTree LayoutBinaryFormat::createTypedCopy (const juce::ValueTree& tree)
+{
+    juce::ValueTree copy (tree.getType());
+    for (int i=0; i < tree.getNumProperties(); ++i) {
+        const juce::Identifier property = tree.getPropertyName (i);
+        if (LayoutItem::isTransientProperty (property)) {
+            continue;
+        }
+        const juce::var& value = tree.getProperty (property);
+        if (property == LayoutItem::propOrientation && value.isString()) {
+            copy.setProperty (property, static_cast<int> (LayoutItem::getOrientationFromName (juce::Identifier (value.toString()))), nullptr);
+        }
+        else if (isNumericProperty (property)) {
+            copy.setProperty (property, toNumber (value), nullptr);
+        }
+        else {
+            copy.setProperty (property, value, nullptr);
+        }
+    }
+    for (int i=0; i < tree.getNumChildren(); ++i) {
+        copy.addChild (createTypedCopy (tree.getChild (i)), -1, nullptr);
+    }
+    return copy;
+}
+
+bool LayoutBinaryFormat::isNumericProperty (const juce::Identifier& property)
+{
+    return property == LayoutItem::propStretchX
+        || property == LayoutItem::propStretchY
+        || property == LayoutItem::propMinWidth
+        || property == LayoutItem::propMaxWidth
+        || property == LayoutItem::propMinHeight
+        || property == LayoutItem::propMaxHeight
+        || property == LayoutItem::propAspectRatio
+        || property == LayoutItem::propPaddingTop
+        || property == LayoutItem::propPaddingLeft
+        || property == LayoutItem::propPaddingRight
+        || property == LayoutItem::propPaddingBottom
+        || property == LayoutItem::propOverlay
+        || property == LayoutItem::propOverlayWidth
+        || property == LayoutItem::propOverlayHeight
+        || property == LayoutItem::propOverlayJustification
+        || property == LayoutItem::propLabelFontSize
+        || property == LayoutItem::propLabelJustification
+        || property == LayoutItem::propGroupJustification
+        || property == LayoutItem::propGridColumn
+        || property == LayoutItem::propGridRow
+        || property == LayoutItem::propGridColumnSpan
+        || property == LayoutItem::propGridRowSpan
+        || property == LayoutItem::propVirtual
+        || property == LayoutSplitter::propRelativePosition
+        || property == LayoutSplitter::propRelativeMinPosition
+        || property == LayoutSplitter::propRelativeMaxPosition
+        || property == Layout::propResizable
+        || property == Layout::propResizerWidth
+        || property == Layout::propResizerHeight;
+}
+
+juce::var LayoutBinaryFormat::toNumber (const juce::var& value)
+{
+    if (! value.isString()) {
+        return value;
+    }
+    const juce::String text = value.toString().trim();
+    if (text.isEmpty()) {
+        return value;
+    }
+    // boolean properties like virtual or resizable accept the same words as juce::var
+    if (text.equalsIgnoreCase ("true") || text.equalsIgnoreCase ("yes")) {
+        return 1;
+    }
+    if (text.equalsIgnoreCase ("false") || text.equalsIgnoreCase ("no")) {
+        return 0;
+    }
+    if (! text.containsAnyOf ("0123456789")) {
+        return value;
+    }
+    if (text.containsOnly ("-+0123456789")) {
+        return text.getIntValue();
+    }
+    if (text.containsOnly ("-+0123456789.eE")) {
+        return text.getDoubleValue();
+    }
+    // not a number, keep the text as it was written
+    return value;
+}
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutBinaryFormat.h
+    Created: 16 Oct 2026 4:05:12pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+#include "ff_layoutItem.h"
+
+//==============================================================================
+/**
+ A compact binary form of a layout definition, which loads faster than xml.
+
+ The data starts with a magic number and a format version, followed by the tree
+ written with juce::ValueTree::writeToStream. Numeric properties are stored as
+ numbers instead of strings and orientations as LayoutItem::Orientation values,
+ so they don't need to be parsed when the layout is read.
+
+ To convert a layout at build time, use convertFromXml, e.g. from the LayoutEditor.
+ To load it, pass the data to the Layout constructor, which accepts binary layouts as well as xml:
+
+ \code{.cpp}
+ Layout layout (BinaryData::main_layout, BinaryData::main_layoutSize, this);
+ \endcode
+ */
+class LayoutBinaryFormat
+{
+public:
+    /** The current version of the format, files with a higher version are rejected */
+    static const int formatVersion;
+
+    /** Returns true, if the data starts with the header of a binary layout */
+    static bool isBinaryLayout (const void* data, size_t size);
+
+    /**
+     Writes the layout tree to out. Transient properties are skipped, numeric
+     properties and orientations are converted to numbers.
+     */
+    static bool write (const juce::ValueTree& tree, juce::OutputStream& out);
+
+    /** Reads a binary layout. Returns an invalid tree, if the data is no binary layout */
+    static juce::ValueTree read (juce::InputStream& in);
+
+    /** Reads a binary layout from memory, e.g. from BinaryData */
+    static juce::ValueTree read (const void* data, size_t size);
+
+    /**
+     Converts a layout definition from xml to the binary format.
+     Returns false, if the xml could not be parsed.
+     */
+    static bool convertFromXml (const juce::String& xml, juce::OutputStream& out);
+
+    /**
+     Returns a deep copy of tree, where numeric properties and orientations are
+     stored as numbers. Transient properties are not copied.
+     */
+    static juce::ValueTree createTypedCopy (const juce::ValueTree& tree);
+
+private:
+    static const juce::uint32 magicNumber;
+
+    static bool isNumericProperty (const juce::Identifier& property);
+
+    static juce::var toNumber (const juce::var& value);
+
+    JUCE_DECLARE_NON_COPYABLE (LayoutBinaryFormat)
+};
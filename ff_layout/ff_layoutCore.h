@@ -41,6 +41,7 @@
 
 
 #include "ff_layoutItem.h"
+#include "ff_layoutPlan.h"
 
 //==============================================================================
 /**
@@ -86,7 +87,9 @@
  @see LayoutItem
  */
 
-class Layout : public LayoutItemListener
+class Layout : public LayoutItemListener,
+               public juce::ValueTree::Listener,
+               private juce::AsyncUpdater
 {
 public:
     
@@ -112,6 +115,9 @@ public:
      \li \p overlayWidth: relative width inside the referenced item
      \li \p overlayHeight: relative height inside the referenced item
      \li \p overlayJustification: justification flag (as integer) where to put the overlay inside the referenced item
+     \li \p gridColumn, \p gridRow: the cell of the item in a grid layout, counted from 0. Items without a cell fill the grid row by row.
+             Items, that don't fill their cell because of their size limits, are placed by their \p overlayJustification
+     \li \p gridColumnSpan, \p gridRowSpan: the number of columns and rows the item covers in a grid layout, 1 by default
      
      The Component understands the additional properties:
      \li \p componentID: the componentID to connect to. All child components of the \p owningComponent are searched
@@ -126,8 +132,15 @@ public:
      \li \p relativeMinPosition: the minimum normalized position to where the splitter can be moved
      
      The Layout has the following properties:
-     \li \p orientation: the direction in which the items are laid out. Possible values are: \p leftToRight, \p topDown, \p rightToLeft and \p bottomUp
+     \li \p orientation: the direction in which the items are laid out. Possible values are: \p leftToRight, \p topDown, \p rightToLeft, \p bottomUp, \p grid and \p flow.
+             A flow places the items left to right with their minimum size (or maximum size, if no minimum is set) and wraps
+             onto a new line, when the width runs out. Items without a width fill a line, items without a height get the line height
+     \li \p gridColumns, \p gridRows: the tracks of a grid layout separated by spaces. Each track is \p stretch, \p stretch:minSize or
+             \p stretch:minSize:maxSize, a track can be repeated by prepending a count, e.g. "32*1" or "1:20 2*2:40:120"
      \li \p layoutBounds: this has only an effect in the root layout, so the layout can be set at fixed positions
+     \li \p virtual: set this to 1 on a \p topDown or \p leftToRight layout to solve only the items inside the visible area.
+             Each item takes its minimum size (or maximum size) in the direction of the layout, 20 pixels if none is set
+             @see setVisibleArea, LayoutViewportConnector
      \li \p groupName: add a GroupComponent around the sub-layout
      \li \p groupText: add a GroupComponent around the sub-layout with the given text
      \li \p groupJustification: specifies the position of the groupText. Add the flags to one integer value
@@ -147,6 +160,12 @@ public:
     Layout (const juce::String& xml, juce::Component* owner=nullptr);
     Layout (const juce::ValueTree& state, juce::Component* owner=nullptr);
 
+    /**
+     Creates the layout from data in memory, e.g. from BinaryData. The data can either
+     be a binary layout written by LayoutBinaryFormat or utf-8 encoded xml.
+     */
+    Layout (const void* data, size_t dataSize, juce::Component* owner=nullptr);
+
     ~Layout ();
     
     /**
@@ -164,8 +183,16 @@ public:
     /**
      Retrieve the LayoutItem for a component. If the Component is not found in the
      Layout, an invalid ValueTree node is returned.
+     The items are looked up in an index, which is kept up to date when items are
+     added, removed or realized.
      */
     juce::ValueTree getLayoutItem (juce::Component*);
+
+    /**
+     Retrieve the LayoutItem with the given componentID. If no item has that componentID,
+     an invalid ValueTree node is returned.
+     */
+    juce::ValueTree getLayoutItem (const juce::String& componentID);
     
     /**
      Call this to connect a fresh state to the owningComponent. In this step layout defined 
@@ -175,13 +202,169 @@ public:
      */
     void realize (juce::Component* owningComponent=nullptr);
     
+    /**
+     Returns the first child of owner with the given componentID. While the layout is
+     realized, this is looked up in a table built once for all children of the owning
+     component, otherwise the children are searched.
+     @internal
+     */
+    juce::Component* findChildWithID (juce::Component* owner, const juce::String& componentID) const;
+
+    /**
+     Returns the first child of owner with the given name, like findChildWithID.
+     @internal
+     */
+    juce::Component* findChildWithName (juce::Component* owner, const juce::String& name) const;
+
+    /**
+     Adds a component created while realizing to the lookup tables, so following
+     items find it like a component added before.
+     @internal
+     */
+    void addChildToLookup (juce::Component* owner, juce::Component* child);
+
+    /**
+     Adds a component created for node after realize, e.g. lazily by the plan, to the
+     index used by getLayoutItem.
+     @internal
+     */
+    void addComponentToIndex (const juce::ValueTree& node, juce::Component* component);
+
+    /**
+     Removes a component from the index used by getLayoutItem, before it is deleted.
+     @internal
+     */
+    void removeComponentFromIndex (const juce::ValueTree& node, juce::Component* component);
+
     /**
      Call this method in your Component::resized() callback.
      If the layout has an owning component, this calls updateGeometry with the
      bounds of the owning component.
+     The tree is compiled into a LayoutPlan on the first call and after each structural
+     change of the state, so the following calls only solve the plan and set the bounds.
+     Changed properties are patched into the plan. If the bounds are the same as in
+     the last call, only the sub layouts containing changed items are solved again.
+     @see LayoutPlan
      */
     void updateGeometry ();
 
+    /**
+     In asynchronous mode updateGeometry only schedules an update, so all calls from
+     resized, splitter drags and changes of the state within one round of the message
+     loop are solved only once. The default is to update synchronously.
+     @see flush
+     */
+    void setAsynchronousUpdates (bool shouldUpdateAsynchronously);
+
+    /**
+     Performs a pending asynchronous update now and waits for a running background
+     solve, so all components have their final bounds when it returns.
+     */
+    void flush ();
+
+    /**
+     Solve the geometry on a thread of pool instead of the message thread. The plan is
+     moved to the solving job and back, only the results are applied to the components
+     on the message thread, after the solve finished. Results, that are outdated by a
+     newer updateGeometry call or a change of the state in the meantime, are not applied,
+     the next solve continues from them.
+     Pass nullptr to solve synchronously again. The pool must outlive the layout.
+     */
+    void setBackgroundSolving (juce::ThreadPool* pool);
+
+    /**
+     The layout keeps the results for the last few root bounds, so returning to a
+     size, e.g. when switching between fixed editor sizes, doesn't need to solve
+     again. The solutions are discarded, when the state changes. Set to 0 to
+     disable the cache, the default is 4.
+     */
+    void setSolutionCacheSize (int numSolutions);
+
+    /**
+     By default realize creates all components the layout owns, i.e. the labels for
+     \p labelText, the GroupComponents for \p groupText and the splitter handles.
+     In lazy mode they are created only when their item gets non-empty bounds for the
+     first time, so items in collapsed or hidden sub layouts don't cost anything.
+     If releaseCollapsed is set, they are deleted again, when their item collapses.
+     Takes effect on the next realize.
+     */
+    void setLazyComponentCreation (bool shouldCreateLazily, bool releaseCollapsed=false);
+
+    /** Returns true, if owned components are created when their item gets bounds @see setLazyComponentCreation */
+    bool isCreatingComponentsLazily () const;
+
+    /**
+     Sets the area of the owning component, that is visible, e.g. the view area of a
+     juce::Viewport showing it. Sub layouts with the \p virtual property solve and move
+     only the items inside that area. If the visible items changed, the geometry is updated.
+     @see LayoutViewportConnector
+     */
+    void setVisibleArea (juce::Rectangle<int> area);
+
+    /** Returns the area set by setVisibleArea */
+    juce::Rectangle<int> getVisibleArea () const;
+
+    /**
+     Distributes the space of sub layouts as whole pixels using the largest remainder, so
+     the items don't jitter by one pixel back and forth while resizing and only the items,
+     whose share really changed, are moved. This is off by default.
+     @see LayoutPlan::setIntegerDistribution
+     */
+    void setIntegerDistribution (bool shouldDistributeIntegers);
+
+    /** Returns true, if the space is distributed as whole pixels */
+    bool isDistributingIntegers () const;
+
+    /**
+     Returns the counters collected for node, like how often it was solved and the time that
+     took. The counters start over, when the structure of the layout changes, only the realize
+     counters are kept until resetInstrumentation.
+     All counters are zero, unless the module is compiled with FF_LAYOUT_ENABLE_INSTRUMENTATION.
+     */
+    LayoutNodeStats getNodeStats (const juce::ValueTree& node);
+
+    /** Sets the counters of all items back to zero, e.g. before measuring a resize */
+    void resetInstrumentation ();
+
+    /**
+     Creates a table of the items, that took the most time to solve without their children,
+     one line per item with all counters. Use this to find the sub layouts, that make resizing slow.
+     */
+    juce::String createInstrumentationReport (int maxNumItems=20);
+
+    /**
+     Starts recording spans of realize, solve, splitter drags, restoring settings and
+     calling listeners. Previously recorded spans are discarded.
+     Nothing is recorded, unless the module is compiled with FF_LAYOUT_ENABLE_INSTRUMENTATION.
+     @see writeTrace
+     */
+    void startTracing ();
+
+    /** Stops recording spans, the recorded spans are kept to be written */
+    void stopTracing ();
+
+    /**
+     Writes the recorded spans in the Chrome trace event JSON format, that trace viewers
+     like chrome://tracing or Perfetto can load. The spans are named by the path of their
+     node in the layout. Returns false, if nothing was recorded.
+     */
+    bool writeTrace (juce::OutputStream& stream) const;
+
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    /** Returns the recorder while tracing, nullptr otherwise @internal */
+    LayoutTraceRecorder* getTraceRecorder () const;
+
+    /** Returns the counters, that LayoutItem::realize adds to for node @internal */
+    LayoutNodeStats& getRealizeStats (const juce::ValueTree& node);
+#endif
+
+    /**
+     Returns the size the root layout needs in its direction to show all items, if it has
+     the \p virtual property set, or 0 otherwise. The size is computed from the sizes of the
+     items without solving them.
+     */
+    int getVirtualContentSize ();
+
     /**
      To show the layout bounds e.g. for debugging yout layout structure simply add the following line to yout Component:
      \code{.cpp}
@@ -193,6 +376,20 @@ public:
      */
     void paintBounds (juce::Graphics& g) const;
 
+    /**
+     Returns the bounds of node applied by the last update. Other than
+     LayoutItem::getItemBounds this works for all items, not only for those with
+     listeners or components. It doesn't wait for a running background solve.
+     */
+    juce::Rectangle<int> getItemBounds (const juce::ValueTree& node) const;
+
+    /**
+     Calls the listeners of a dragged splitter with its position. The update clamps the
+     position to the size limits, so in asynchronous or background mode the listeners
+     are called after the next update was applied.
+     */
+    void callSplitterListenersAfterUpdate (const juce::ValueTree& splitter);
+
     /** Clears the layout and resets to zero state */
     void clearLayout (juce::UndoManager* undo=nullptr);
     
@@ -206,6 +403,17 @@ public:
 
     /** This is the callback to track resizer settings */
     void layoutSplitterMoved (juce::ValueTree item, float relativePos, bool final) override;
+
+    /** @internal */
+    void valueTreePropertyChanged (juce::ValueTree& tree, const juce::Identifier& property) override;
+    /** @internal */
+    void valueTreeChildAdded (juce::ValueTree& parent, juce::ValueTree& child) override;
+    /** @internal */
+    void valueTreeChildRemoved (juce::ValueTree& parent, juce::ValueTree& child, int index) override;
+    /** @internal */
+    void valueTreeChildOrderChanged (juce::ValueTree& parent, int oldIndex, int newIndex) override;
+    /** @internal */
+    void valueTreeParentChanged (juce::ValueTree& tree) override;
     
     /** Use the state to identify nodes in the hierarchy where to add layout items */
     juce::ValueTree state;
@@ -246,5 +454,148 @@ private:
     std::unique_ptr<juce::ResizableCornerComponent>     resizer;
     std::unique_ptr<juce::ComponentBoundsConstrainer>   resizeConstraints;
 
+    /**
+     The flat copy of state used by updateGeometry. It is compiled again after
+     children were added or removed, changed properties are updated in place.
+     */
+    LayoutPlan                                          plan;
+
+    /** Set while the results of the plan are written back, to ignore our own changes */
+    bool                                                isApplyingPlan;
+
+    /**
+     Changes of the model made while the plan is applied or solved in the background.
+     The plan is in use then, so it is updated afterwards.
+     */
+    juce::Array<std::pair<juce::ValueTree, juce::Identifier> > queuedPropertyChanges;
+
+    /** Dragged splitters, whose listeners are called after the next apply */
+    juce::Array<juce::ValueTree>                        splittersToReport;
+
+    /** The bounds of the root in the last update, its listeners get them after the next apply */
+    juce::Rectangle<int>                                rootBounds;
+
+    /** The bounds the root listeners were called with last */
+    juce::Rectangle<int>                                rootListenerBounds;
+
+    /**
+     The plan notifies only the children, so the root listeners are called here. Like the
+     other items they are called only if the bounds changed.
+     */
+    void callRootListeners ();
+
+    /** Set if children were added or removed by a listener or a component while applying */
+    bool                                                structureChangedWhileApplying;
+
+    /** Set if children were added or removed while the plan was solved in the background */
+    bool                                                structureChangedWhileSolving;
+
+    /** Clears the plan after a structural change, so it is compiled again */
+    void clearPlan ();
+
+    /** Updates the plan with the property changes, that were queued while it was in use */
+    void updatePlanForQueuedChanges ();
+
+    /** Reads a changed property into the plan and the component index */
+    void updatePlanForProperty (juce::ValueTree& tree, const juce::Identifier& property);
+
+    /** @internal */
+    void handleAsyncUpdate () override;
+
+    /** Does the work of updateGeometry */
+    void updateGeometryNow ();
+
+    bool                                                asynchronousUpdates;
+
+    bool                                                lazyComponentCreation;
+    bool                                                releaseCollapsedComponents;
+
+    class BackgroundSolver;
+    friend class BackgroundSolver;
+
+    void startBackgroundSolve ();
+
+    /**
+     Waits for a running background solve and takes the plan back without applying it.
+     A result is applied by the next update.
+     */
+    void stopBackgroundSolve ();
+
+    void backgroundSolveFinished ();
+
+    /** Moves the plan back from the finished job */
+    void takePlanFrom (BackgroundSolver& finished);
+
+    /** The pool to solve in the background, if set */
+    juce::ThreadPool*                                   solverPool;
+    std::unique_ptr<BackgroundSolver>                   backgroundSolver;
+    juce::Rectangle<int>                                requestedBounds;
+    int                                                 requestedGeneration;
+
+    /** Counts the changes of the state to detect outdated background results and solutions */
+    int                                                 stateVersion;
+
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    std::unique_ptr<LayoutTraceRecorder>                traceRecorder;
+    bool                                                isTracing;
+
+    /**
+     The realize counters by node. Realize runs before the node is part of the plan, and
+     they are kept outside the tree, so counting doesn't change the state.
+     */
+    juce::Array<juce::ValueTree>                        realizedNodes;
+    juce::OwnedArray<LayoutNodeStats>                   realizeStats;
+
+    /** Returns the stats of the plan at index including the realize counters */
+    LayoutNodeStats getNodeStats (int index) const;
+#endif
+
+    /** Compiles the plan, if the state was changed */
+    void compilePlan ();
+
+    /** Applies the solved plan and stores the solution in the cache, if requested */
+    void applyPlan (bool storeSolution);
+
+    /** Restores the solution for bounds from the cache, returns false if none is found */
+    bool restoreCachedSolution (juce::Rectangle<int> bounds);
+
+    /** Recently used solutions, the most recent one at the end */
+    juce::OwnedArray<LayoutPlan::Solution>              solutionCache;
+    int                                                 solutionCacheSize;
+    int                                                 solutionCacheVersion;
+
+    /** Adds node and all items below to the lookup tables */
+    void addToIndex (const juce::ValueTree& node);
+
+    /** Removes node and all items below from the lookup tables */
+    void removeFromIndex (const juce::ValueTree& node);
+
+    /** Builds the lookup tables for the whole state */
+    void rebuildIndex ();
+
+    /**
+     Lookup tables for the children of the owning component by componentID and name.
+     They are only valid while realize is running, since children can be deleted anytime.
+     */
+    juce::Component*                                    childLookupOwner;
+    juce::HashMap<juce::String, juce::Component*>       childrenByID;
+    juce::HashMap<juce::String, juce::Component*>       childrenByName;
+
+    struct ComponentHash
+    {
+        int generateHash (juce::Component* key, int upperLimit) const noexcept
+        {
+            // the lower bits of a pointer are always zero due to alignment
+            const juce::pointer_sized_uint value = reinterpret_cast<juce::pointer_sized_uint> (key) >> 4;
+            return static_cast<int> (value % static_cast<juce::pointer_sized_uint> (upperLimit));
+        }
+    };
+
+    /**
+     Lookup tables to find items by component or componentID. Entries can be outdated,
+     so a found node is checked before it is returned.
+     */
+    juce::HashMap<juce::Component*, juce::ValueTree, ComponentHash> componentIndex;
+    juce::HashMap<juce::String, juce::ValueTree>                   componentIDIndex;
 
 };
@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutDistribution.h
+    Created: 16 Oct 2026 11:48:05pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ff_layoutItem.h"
+
+//==============================================================================
+/**
+ The distribution of the space of a sub layout to its children, shared by
+ LayoutPlan and StaticLayout::Solver.
+
+ The functions work on the slots from start to stop of a sub layout through an
+ adaptor, which provides these members:
+
+ \code{.cpp}
+ bool  isFlexible (int slot) const;                     // false for overlays
+ bool  isFrozen (int slot) const;
+ void  freeze (int slot);
+ float getStretch (int slot);                           // in the direction of the sub layout
+ float getSize (int slot) const;
+ void  setSize (int slot, float size);
+ float clampToSizeLimits (int slot, float size) const;
+ \endcode
+ */
+namespace LayoutDistribution
+{
+    /** Clamps size to the limits, the minimum wins like in LayoutItem::constrainBounds */
+    inline float clampToSizeLimits (float size, int minSize, int maxSize)
+    {
+        if (maxSize > 0 && size > maxSize) {
+            size = maxSize;
+        }
+        if (minSize > 0 && size < minSize) {
+            size = minSize;
+        }
+        return size;
+    }
+
+    /**
+     Distributes space by stretch like resolving flexible lengths in a flexbox: the sizes
+     are clamped to the size limits and the items violating in the direction of the total
+     violation are frozen. Each pass freezes at least one item, so there are at most as
+     many passes as items. Frozen items keep their size.
+     Returns the pixels the items need in addition to space.
+     */
+    template <typename Items>
+    int resolveFlexibleSizes (Items& items, float space, int start, int stop)
+    {
+        for (;;) {
+            float remaining = space;
+            float stretch   = 0.0f;
+            int   numFlexible = 0;
+            for (int slot = start; slot < stop; ++slot) {
+                if (items.isFlexible (slot)) {
+                    if (items.isFrozen (slot)) {
+                        remaining -= items.getSize (slot);
+                    }
+                    else {
+                        stretch += items.getStretch (slot);
+                        ++numFlexible;
+                    }
+                }
+            }
+            if (numFlexible == 0) {
+                return std::max (static_cast<int>(-remaining), 0);
+            }
+
+            float violation = 0.0f;
+            for (int slot = start; slot < stop; ++slot) {
+                if (items.isFlexible (slot) && ! items.isFrozen (slot)) {
+                    const float target  = stretch > 0.0f ? std::max (remaining, 0.0f) * items.getStretch (slot) / stretch : 0.0f;
+                    const float clamped = items.clampToSizeLimits (slot, target);
+                    items.setSize (slot, clamped);
+                    violation += clamped - target;
+                }
+            }
+            if (violation == 0.0f) {
+                return std::max (static_cast<int>(-remaining), 0);
+            }
+
+            for (int slot = start; slot < stop; ++slot) {
+                if (items.isFlexible (slot) && ! items.isFrozen (slot)) {
+                    const float target  = stretch > 0.0f ? std::max (remaining, 0.0f) * items.getStretch (slot) / stretch : 0.0f;
+                    const float clamped = items.getSize (slot);
+                    if ((violation > 0.0f && clamped > target) || (violation < 0.0f && clamped < target)) {
+                        items.freeze (slot);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     Rounds the sizes to whole pixels using the largest remainder: the items are rounded
+     down and the pixels missing to the total go to the items with the largest fractions,
+     equal fractions go to the earlier item. order is scratch space for stop - start slots.
+     */
+    template <typename Items>
+    void distributeIntegerSizes (Items& items, int start, int stop, int* order)
+    {
+        float total = 0.0f;
+        int   rounded = 0;
+        int   numOrdered = 0;
+        for (int slot = start; slot < stop; ++slot) {
+            if (items.isFlexible (slot)) {
+                const float size = items.getSize (slot);
+                total   += size;
+                rounded += static_cast<int>(std::floor (size));
+                order[numOrdered++] = slot;
+            }
+        }
+
+        int missing = juce::roundToInt (total) - rounded;
+        if (missing > 0) {
+            std::stable_sort (order, order + numOrdered, [&items] (int a, int b)
+                              {
+                                  const float sizeA = items.getSize (a);
+                                  const float sizeB = items.getSize (b);
+                                  return sizeA - std::floor (sizeA) > sizeB - std::floor (sizeB);
+                              });
+        }
+        for (int i=0; i < numOrdered; ++i) {
+            const int slot = order[i];
+            const float size = std::floor (items.getSize (slot));
+            items.setSize (slot, missing > 0 ? size + 1.0f : size);
+            --missing;
+        }
+    }
+
+    /**
+     Computes the range of a splitter position in a sub layout of bounds, so the items
+     before the splitter keep leftMin and the ones after keep rightMin. Horizontal sub
+     layouts use the widths, vertical ones the heights. Returns false for other sub
+     layouts and if the sub layout has no size in its direction.
+     */
+    inline bool getSplitterLimits (LayoutItem::Orientation orientation, juce::Rectangle<int> bounds,
+                                   int leftMinW, int leftMinH, int rightMinW, int rightMinH,
+                                   float& minPosition, float& maxPosition)
+    {
+        const bool vertical = orientation == LayoutItem::TopDown || orientation == LayoutItem::BottomUp;
+        if (! vertical && orientation != LayoutItem::LeftToRight && orientation != LayoutItem::RightToLeft) {
+            return false;
+        }
+        const float size = vertical ? bounds.getHeight() : bounds.getWidth();
+        if (size <= 0) {
+            return false;
+        }
+        const float leftMin  = static_cast<float>(vertical ? leftMinH  : leftMinW)  / size;
+        const float rightMin = static_cast<float>(vertical ? rightMinH : rightMinW) / size;
+        if (orientation == LayoutItem::LeftToRight || orientation == LayoutItem::TopDown) {
+            minPosition = leftMin;
+            maxPosition = 1.0f - rightMin;
+        }
+        else {
+            minPosition = 1.0f - leftMin;
+            maxPosition = rightMin;
+        }
+        return true;
+    }
+
+    /** Returns position clamped to the range of getSplitterLimits */
+    inline float clampSplitterPosition (float position, float minPosition, float maxPosition)
+    {
+        if (position < minPosition) {
+            return minPosition;
+        }
+        if (position > maxPosition) {
+            return maxPosition;
+        }
+        return position;
+    }
+}
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutInstrumentation.cpp
+    Created: 16 Oct 2026 9:58:17pm
+
+  ==============================================================================
+*/
+
+
+#include "ff_layout.h"
+
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+
+LayoutTraceRecorder::LayoutTraceRecorder ()
+{
+}
+
+void LayoutTraceRecorder::addSpan (const juce::String& name, const char* category, juce::int64 startTicks, juce::int64 endTicks)
+{
+    Span span;
+    span.name       = name;
+    span.category   = category;
+    span.startTicks = startTicks;
+    span.endTicks   = endTicks;
+    span.thread     = juce::Thread::getCurrentThreadId();
+
+    const juce::ScopedLock sl (lock);
+    spans.add (span);
+}
+
+void LayoutTraceRecorder::clear ()
+{
+    const juce::ScopedLock sl (lock);
+    spans.clear();
+}
+
+int LayoutTraceRecorder::getNumSpans () const
+{
+    const juce::ScopedLock sl (lock);
+    return spans.size();
+}
+
+void LayoutTraceRecorder::writeTo (juce::OutputStream& stream) const
+{
+    const juce::ScopedLock sl (lock);
+
+    // the trace viewers want small numbers as thread ids, so number the threads in order of appearance
+    juce::Array<juce::Thread::ThreadID> threads;
+
+    stream << "{\"traceEvents\":[";
+    for (int i=0; i < spans.size(); ++i) {
+        const Span& span = spans.getReference (i);
+        threads.addIfNotAlreadyThere (span.thread);
+        const double start    = juce::Time::highResolutionTicksToSeconds (span.startTicks) * 1000000.0;
+        const double duration = juce::Time::highResolutionTicksToSeconds (span.endTicks - span.startTicks) * 1000000.0;
+        if (i > 0) {
+            stream << ",";
+        }
+        stream << "\n{\"name\":" << juce::JSON::toString (span.name)
+               << ",\"cat\":\"" << span.category
+               << "\",\"ph\":\"X\",\"ts\":" << juce::String (start, 3)
+               << ",\"dur\":" << juce::String (duration, 3)
+               << ",\"pid\":1,\"tid\":" << threads.indexOf (span.thread) + 1 << "}";
+    }
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+juce::String LayoutTraceRecorder::getNodeName (const juce::ValueTree& node, int indexInParent)
+{
+    juce::String name = node.getType().toString();
+    if (indexInParent >= 0) {
+        name << "[" << indexInParent << "]";
+    }
+    const juce::String componentID = node.getProperty (LayoutItem::propComponentID).toString();
+    if (componentID.isNotEmpty()) {
+        name << ":" << componentID;
+    }
+    return name;
+}
+
+juce::String LayoutTraceRecorder::getNodePath (const juce::ValueTree& node)
+{
+    juce::String path;
+    for (juce::ValueTree current = node; current.isValid(); current = current.getParent()) {
+        const juce::ValueTree parent = current.getParent();
+        const juce::String name = getNodeName (current, parent.isValid() ? parent.indexOf (current) : -1);
+        path = path.isEmpty() ? name : name + "/" + path;
+    }
+    return path;
+}
+
+//==============================================================================
+
+LayoutTraceRecorder::ScopedSpan::ScopedSpan (LayoutTraceRecorder* recorderToUse, const juce::ValueTree& node, const char* category_)
+  : recorder (recorderToUse),
+    category (category_),
+    startTicks (0)
+{
+    if (recorder != nullptr) {
+        name = getNodePath (node);
+        startTicks = juce::Time::getHighResolutionTicks();
+    }
+}
+
+LayoutTraceRecorder::ScopedSpan::ScopedSpan (LayoutTraceRecorder* recorderToUse, const juce::String& name_, const char* category_)
+  : recorder (recorderToUse),
+    name (name_),
+    category (category_),
+    startTicks (recorderToUse != nullptr ? juce::Time::getHighResolutionTicks() : 0)
+{
+}
+
+LayoutTraceRecorder::ScopedSpan::~ScopedSpan ()
+{
+    if (recorder != nullptr) {
+        recorder->addSpan (name, category, startTicks, juce::Time::getHighResolutionTicks());
+    }
+}
+
+#endif // FF_LAYOUT_ENABLE_INSTRUMENTATION
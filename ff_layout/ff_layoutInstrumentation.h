@@ -0,0 +1,182 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutInstrumentation.h
+    Created: 16 Oct 2026 9:12:40pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+#include "juce_gui_basics/juce_gui_basics.h"
+
+//==============================================================================
+/**
+ Counters and timings of a single layout item. They are only collected, if the module
+ is compiled with FF_LAYOUT_ENABLE_INSTRUMENTATION set to 1, otherwise all stay zero and
+ recording them costs nothing.
+ The times are measured in high resolution ticks, use the getters to get seconds.
+ @see Layout::getNodeStats, Layout::createInstrumentationReport
+ */
+struct LayoutNodeStats
+{
+    /** How often the item was solved, sub layouts computed their children then */
+    int         numSolves           = 0;
+
+    /** How often the item was realized, i.e. its component was looked up or created */
+    int         numRealizes         = 0;
+
+    /** How often the component of the item was moved by setBounds */
+    int         numSetBounds        = 0;
+
+    /** How many listener callbacks were called for the item */
+    int         numListenerCalls    = 0;
+
+    /** How often the plan read the properties of the item from the state, i.e. compiles and patches */
+    int         numPropertyUpdates  = 0;
+
+    /** Time spent solving the item including its children */
+    juce::int64 inclusiveTicks      = 0;
+
+    /** Time spent solving the item without the time of its children */
+    juce::int64 exclusiveTicks      = 0;
+
+    /** Time spent realizing the item including its children */
+    juce::int64 realizeTicks        = 0;
+
+    double getInclusiveSeconds () const { return juce::Time::highResolutionTicksToSeconds (inclusiveTicks); }
+    double getExclusiveSeconds () const { return juce::Time::highResolutionTicksToSeconds (exclusiveTicks); }
+    double getRealizeSeconds ()   const { return juce::Time::highResolutionTicksToSeconds (realizeTicks); }
+};
+
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+
+/**
+ Adds the time between construction and destruction to a tick counter.
+ @internal
+ */
+class LayoutScopedTicks
+{
+public:
+    LayoutScopedTicks (juce::int64& counterToAddTo)
+      : counter (counterToAddTo),
+        startTicks (juce::Time::getHighResolutionTicks())
+    {
+    }
+
+    ~LayoutScopedTicks ()
+    {
+        counter += juce::Time::getHighResolutionTicks() - startTicks;
+    }
+
+private:
+    juce::int64&        counter;
+    const juce::int64   startTicks;
+
+    JUCE_DECLARE_NON_COPYABLE (LayoutScopedTicks)
+};
+
+//==============================================================================
+/**
+ Records spans of layout activity like realize, solve, splitter drags, restoring settings
+ and calling listeners, and writes them in the Chrome trace event format. The written file
+ can be loaded into chrome://tracing or Perfetto next to traces of the application.
+ Each span is named after the path of its node in the layout tree. Spans can be added
+ from any thread, so background solves are recorded as well.
+ @see Layout::startTracing
+ */
+class LayoutTraceRecorder
+{
+public:
+    LayoutTraceRecorder ();
+
+    /** Adds a span, the ticks are juce::Time::getHighResolutionTicks */
+    void addSpan (const juce::String& name, const char* category, juce::int64 startTicks, juce::int64 endTicks);
+
+    /** Removes all recorded spans */
+    void clear ();
+
+    /** Returns the number of recorded spans */
+    int getNumSpans () const;
+
+    /** Writes all spans as trace event JSON */
+    void writeTo (juce::OutputStream& stream) const;
+
+    /** Returns the name of node like "Component[0]:gain", the index is left out if it is negative */
+    static juce::String getNodeName (const juce::ValueTree& node, int indexInParent);
+
+    /**
+     Returns the path of node like "Layout/SubLayout[1]/Component[0]:gain" to name spans.
+     This walks the ValueTree, so call it only on the message thread.
+     */
+    static juce::String getNodePath (const juce::ValueTree& node);
+
+    /**
+     Adds a span from construction to destruction. The recorder can be nullptr, which is
+     the case while not tracing, then nothing is recorded.
+     */
+    class ScopedSpan
+    {
+    public:
+        ScopedSpan (LayoutTraceRecorder* recorderToUse, const juce::ValueTree& node, const char* category);
+        ScopedSpan (LayoutTraceRecorder* recorderToUse, const juce::String& name, const char* category);
+        ~ScopedSpan ();
+
+    private:
+        LayoutTraceRecorder*    recorder;
+        juce::String            name;
+        const char*             category;
+        juce::int64             startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedSpan)
+    };
+
+private:
+    struct Span
+    {
+        juce::String            name;
+        const char*             category;
+        juce::int64             startTicks;
+        juce::int64             endTicks;
+        juce::Thread::ThreadID  thread;
+    };
+
+    juce::CriticalSection       lock;
+    juce::Array<Span>           spans;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LayoutTraceRecorder)
+};
+
+#endif // FF_LAYOUT_ENABLE_INSTRUMENTATION
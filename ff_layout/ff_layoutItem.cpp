@@ -54,6 +54,8 @@ const juce::Identifier LayoutItem::orientationLeftToRight   ("leftToRight");
 const juce::Identifier LayoutItem::orientationTopDown       ("topDown");
 const juce::Identifier LayoutItem::orientationRightToLeft   ("rightToLeft");
 const juce::Identifier LayoutItem::orientationBottomUp      ("bottomUp");
+const juce::Identifier LayoutItem::orientationGrid          ("grid");
+const juce::Identifier LayoutItem::orientationFlow          ("flow");
 
 const juce::Identifier LayoutItem::propStretchX             ("stretchX");
 const juce::Identifier LayoutItem::propStretchY             ("stretchY");
@@ -74,6 +76,14 @@ const juce::Identifier LayoutItem::propOverlayWidth         ("overlayWidth");
 const juce::Identifier LayoutItem::propOverlayHeight        ("overlayHeight");
 const juce::Identifier LayoutItem::propOverlayJustification ("overlayJustification");
 
+const juce::Identifier LayoutItem::propGridColumns          ("gridColumns");
+const juce::Identifier LayoutItem::propGridRows             ("gridRows");
+const juce::Identifier LayoutItem::propGridColumn           ("gridColumn");
+const juce::Identifier LayoutItem::propGridRow              ("gridRow");
+const juce::Identifier LayoutItem::propGridColumnSpan       ("gridColumnSpan");
+const juce::Identifier LayoutItem::propGridRowSpan          ("gridRowSpan");
+const juce::Identifier LayoutItem::propVirtual              ("virtual");
+
 const juce::Identifier LayoutItem::propComponentID          ("componentID");
 const juce::Identifier LayoutItem::propComponentName        ("componentName");
 const juce::Identifier LayoutItem::propLabelText            ("labelText");
@@ -84,9 +94,6 @@ const juce::Identifier LayoutItem::propGroupText            ("groupText");
 const juce::Identifier LayoutItem::propGroupJustification   ("groupJustification");
 
 const juce::Identifier LayoutItem::volatileSharedLayoutData ("volatileSharedLayoutData");
-const juce::Identifier LayoutItem::volatileItemBounds       ("volatileItemBounds");
-const juce::Identifier LayoutItem::volatileItemBoundsFixed  ("volatileItemBoundsFixed");
-const juce::Identifier LayoutItem::volatileIsUpdating       ("volatileIsUpdating");
 
 
 LayoutItem::LayoutItem (LayoutItem::Orientation o)
@@ -183,7 +190,16 @@ void LayoutItem::setOrientation (const Orientation o, juce::UndoManager* undo)
 
 LayoutItem::Orientation LayoutItem::getOrientation() const
 {
-    return getOrientationFromName (juce::Identifier (state.getProperty (propOrientation, LayoutItem::orientationUnknown.toString())));
+    const juce::var& orientation = state.getProperty (propOrientation);
+    // binary layouts store the orientation as number
+    if (orientation.isInt()) {
+        const int value = orientation;
+        return (value >= Unknown && value <= FlowLayout) ? static_cast<Orientation> (value) : Unknown;
+    }
+    if (orientation.isVoid()) {
+        return Unknown;
+    }
+    return getOrientationFromName (juce::Identifier (orientation.toString()));
 }
 
 bool LayoutItem::isHorizontal () const
@@ -198,6 +214,11 @@ bool LayoutItem::isVertical () const
     return o == TopDown || o == BottomUp;
 }
 
+bool LayoutItem::isGrid () const
+{
+    return getOrientation() == GridLayout;
+}
+
 LayoutItem::Orientation LayoutItem::getOrientationFromName (juce::Identifier name)
 {
     if (name == orientationLeftToRight) {
@@ -212,6 +233,12 @@ LayoutItem::Orientation LayoutItem::getOrientationFromName (juce::Identifier nam
     else if (name == orientationBottomUp) {
         return LayoutItem::BottomUp;
     }
+    else if (name == orientationGrid) {
+        return LayoutItem::GridLayout;
+    }
+    else if (name == orientationFlow) {
+        return LayoutItem::FlowLayout;
+    }
     else
         return LayoutItem::Unknown;
 }
@@ -230,6 +257,12 @@ juce::Identifier LayoutItem::getNameFromOrientation (LayoutItem::Orientation o)
     else if (o == LayoutItem::BottomUp) {
         return orientationBottomUp;
     }
+    else if (o == LayoutItem::GridLayout) {
+        return orientationGrid;
+    }
+    else if (o == LayoutItem::FlowLayout) {
+        return orientationFlow;
+    }
     else
         return orientationUnknown;
 }
@@ -272,20 +305,16 @@ void LayoutItem::setOverlayJustification (int j)
 
 bool LayoutItem::hasComponent () const
 {
-    if (state.hasProperty (volatileSharedLayoutData)) {
-        if (SharedLayoutData* data = dynamic_cast<SharedLayoutData*>(state.getProperty(volatileSharedLayoutData).getObject())) {
-            return data->hasComponent();
-        }
+    if (SharedLayoutData* data = getSharedData (state)) {
+        return data->hasComponent();
     }
     return false;
 }
 
 juce::Component* LayoutItem::getComponent () const
 {
-    if (state.hasProperty (volatileSharedLayoutData)) {
-        if (SharedLayoutData* data = dynamic_cast<SharedLayoutData*>(state.getProperty(volatileSharedLayoutData).getObject())) {
-            return data->getComponent();
-        }
+    if (SharedLayoutData* data = getSharedData (state)) {
+        return data->getComponent();
     }
     return nullptr;
 }
@@ -295,6 +324,12 @@ juce::String LayoutItem::getComponentID () const
     return state.getProperty (propComponentID, "");
 }
 
+LayoutItem::SharedLayoutData* LayoutItem::getSharedData (const juce::ValueTree& node)
+{
+    // getProperty returns a void var if the property doesn't exist, so this is a single lookup
+    return dynamic_cast<SharedLayoutData*>(node.getProperty (volatileSharedLayoutData).getObject());
+}
+
 LayoutItem::SharedLayoutData* LayoutItem::getOrCreateData (juce::ValueTree& node, juce::UndoManager* undo)
 {
     if (node.hasProperty (volatileSharedLayoutData)) {
@@ -304,8 +339,9 @@ LayoutItem::SharedLayoutData* LayoutItem::getOrCreateData (juce::ValueTree& node
         // ouch, somebody put a wrong object into that property!
         jassertfalse;
     }
+    // transient data must not end up in the undo history
     SharedLayoutData* data = new SharedLayoutData;
-    node.setProperty (volatileSharedLayoutData, data, undo);
+    node.setProperty (volatileSharedLayoutData, data, nullptr);
     return data;
 }
 
@@ -482,12 +518,14 @@ juce::ValueTree LayoutItem::getLayoutItem (juce::ValueTree& node, juce::String&
 
 void LayoutItem::constrainBounds (juce::Rectangle<int>& bounds, bool& changedWidth, bool& changedHeight, bool preferVertical)
 {
-    int cbMinWidth = getMinimumWidth();
-    int cbMaxWidth = getMaximumWidth();
-    int cbMinHeight = getMinimumHeight();
-    int cbMaxHeight = getMaximumHeight();
-    float aspectRatio = getAspectRatio();
-    
+    LayoutItem::constrainBounds (bounds, changedWidth, changedHeight, preferVertical,
+                                 getMinimumWidth(), getMaximumWidth(), getMinimumHeight(), getMaximumHeight(),
+                                 getAspectRatio());
+}
+
+void LayoutItem::constrainBounds (juce::Rectangle<int>& bounds, bool& changedWidth, bool& changedHeight, bool preferVertical,
+                                  int cbMinWidth, int cbMaxWidth, int cbMinHeight, int cbMaxHeight, float aspectRatio)
+{
     changedWidth  = false;
     changedHeight = false;
     
@@ -519,7 +557,7 @@ void LayoutItem::constrainBounds (juce::Rectangle<int>& bounds, bool& changedWid
 
 void LayoutItem::setItemBounds (juce::Rectangle<int> b)
 {
-    state.setProperty (volatileItemBounds, b.toString(), nullptr);
+    getOrCreateData()->itemBounds = b;
 }
 
 void LayoutItem::setItemBounds (int x, int y, int w, int h)
@@ -529,9 +567,8 @@ void LayoutItem::setItemBounds (int x, int y, int w, int h)
 
 juce::Rectangle<int> LayoutItem::getItemBounds() const
 {
-    if (state.hasProperty (volatileItemBounds)) {
-        juce::Rectangle<int> bounds = juce::Rectangle<int>::fromString (state.getProperty (volatileItemBounds).toString());
-        return bounds;
+    if (SharedLayoutData* data = getSharedData (state)) {
+        return data->itemBounds;
     }
     return juce::Rectangle<int>();
 }
@@ -549,15 +586,23 @@ juce::Rectangle<int> LayoutItem::getPaddedItemBounds () const
 
 void LayoutItem::setBoundsAreFinal (bool final)
 {
-    state.setProperty (volatileItemBoundsFixed, final, nullptr);
+    getOrCreateData()->boundsAreFinal = final;
 }
 
 bool LayoutItem::getBoundsAreFinal() const
 {
-    return state.getProperty (volatileItemBoundsFixed, false);
+    if (SharedLayoutData* data = getSharedData (state)) {
+        return data->boundsAreFinal;
+    }
+    return false;
+}
+
+bool LayoutItem::isTransientProperty (const juce::Identifier& property)
+{
+    return property == volatileSharedLayoutData;
 }
 
-void LayoutItem::paintBounds (const juce::ValueTree& node, juce::Graphics& g)
+void LayoutItem::paintBounds (const Layout& layout, const juce::ValueTree& node, juce::Graphics& g)
 {
     LayoutItem item (node);
     if (item.isHorizontal()) {
@@ -571,17 +616,16 @@ void LayoutItem::paintBounds (const juce::ValueTree& node, juce::Graphics& g)
     }
     for (int i=0; i<node.getNumChildren(); ++i) {
         juce::ValueTree child (node.getChild (i));
-        const LayoutItem childItem (child);
         if (child.getType() == itemTypeSubLayout) {
             g.saveState();
-            LayoutItem::paintBounds (child, g);
-            juce::Rectangle<int> bounds (childItem.getItemBounds());
+            LayoutItem::paintBounds (layout, child, g);
+            juce::Rectangle<int> bounds (layout.getItemBounds (child));
             if (!bounds.isEmpty())
                 g.drawRect (bounds);
             g.restoreState();
         }
         else {
-            g.drawRect (childItem.getItemBounds().reduced(1));
+            g.drawRect (layout.getItemBounds (child).reduced(1));
         }
     }
 }
@@ -610,61 +654,58 @@ void LayoutItem::fixUpLayoutItems ()
 
 void LayoutItem::realize (juce::ValueTree& node, juce::Component* owningComponent, Layout* layout)
 {
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    // without a layout there is nowhere to keep the counters
+    LayoutNodeStats unrecorded;
+    LayoutNodeStats& stats = layout != nullptr ? layout->getRealizeStats (node) : unrecorded;
+    ++stats.numRealizes;
+    const LayoutScopedTicks realizeTimer (stats.realizeTicks);
+    const LayoutTraceRecorder::ScopedSpan realizeSpan (layout != nullptr ? layout->getTraceRecorder() : nullptr, node, "realize");
+#endif
+
     LayoutItem item (node);
     if (node.getType() == itemTypeComponent) {
         if (node.hasProperty (propComponentID)) {
-            if (juce::Component* component = owningComponent->findChildWithID (node.getProperty (propComponentID).toString())) {
+            const juce::String componentID = node.getProperty (propComponentID).toString();
+            juce::Component* component = layout ? layout->findChildWithID (owningComponent, componentID)
+                                                : owningComponent->findChildWithID (componentID);
+            if (component) {
                 item.setComponent (component, false);
                 return;
             }
         }
         if (node.hasProperty (propComponentName)) {
             juce::String name = node.getProperty (propComponentName);
-            for (int i=0; i < owningComponent->getNumChildComponents(); ++i) {
-                juce::Component* child = owningComponent->getChildComponent (i);
-                if (child->getName() == name) {
+            if (layout) {
+                if (juce::Component* child = layout->findChildWithName (owningComponent, name)) {
                     item.setComponent (child, false);
                     return;
                 }
             }
+            else {
+                for (int i=0; i < owningComponent->getNumChildComponents(); ++i) {
+                    juce::Component* child = owningComponent->getChildComponent (i);
+                    if (child->getName() == name) {
+                        item.setComponent (child, false);
+                        return;
+                    }
+                }
+            }
         }
         if (node.hasProperty (propLabelText)) {
-            juce::Label* newLabel = new juce::Label();
-            newLabel->setText (juce::LocalisedStrings::translateWithCurrentMappings (node.getProperty (propLabelText).toString()), juce::dontSendNotification);
-            if (node.hasProperty (propLabelFontSize)) {
-                newLabel->setFont (juce::Font (node.getProperty (propLabelFontSize), 12.0));
-            }
-            if (node.hasProperty (propLabelJustification)) {
-                newLabel->setJustificationType (juce::Justification (node.getProperty (propLabelJustification, 36)));
-            }
-            if (node.hasProperty (propComponentName)) {
-                newLabel->setName (node.getProperty (propComponentName).toString());
-            }
-            if (node.hasProperty (propComponentID)) {
-                newLabel->setComponentID (node.getProperty (propComponentID).toString());
-            }
-            
-            owningComponent->addAndMakeVisible (newLabel);
-            item.setComponent (newLabel, true);
+            realizeOwnedComponent (node, owningComponent, layout);
         }
     }
     else if (node.getType() == itemTypeSplitter) {
-        LayoutSplitter::Component* splitterComponent = new LayoutSplitter::Component (layout);
         LayoutSplitter splitter (node);
         LayoutItem parent (node.getParent());
-        if (node.hasProperty (propComponentID)) {
-            splitterComponent->setComponentID (node.getProperty (propComponentID).toString());
-        }
         if (parent.isHorizontal()) {
             splitter.setFixedWidth (3);
-            splitterComponent->setMouseCursor (juce::MouseCursor::LeftRightResizeCursor);
         }
         else {
             splitter.setFixedHeight (3);
-            splitterComponent->setMouseCursor (juce::MouseCursor::UpDownResizeCursor);
         }
-        splitter.setComponent (splitterComponent, owningComponent);
-        owningComponent->addAndMakeVisible (splitterComponent);
+        realizeOwnedComponent (node, owningComponent, layout);
         splitter.addListener (layout);
     }
     else if (node.getType() == itemTypeBuilder) {
@@ -680,23 +721,13 @@ void LayoutItem::realize (juce::ValueTree& node, juce::Component* owningComponen
                 component->setComponentID (node.getProperty (propComponentID).toString());
             }
             owningComponent->addAndMakeVisible (component);
+            if (layout) layout->addChildToLookup (owningComponent, component);
             item.setComponent (component, true /* owned */);
         }
     }
     else if (node.getType() == itemTypeSubLayout) {
         if (node.hasProperty (propGroupName) || node.hasProperty (propGroupText)) {
-            juce::GroupComponent* group = new juce::GroupComponent();
-            if (node.hasProperty (propGroupName)) {
-                group->setName (node.getProperty (propGroupName).toString());
-            }
-            if (node.hasProperty (propGroupText)) {
-                group->setText (juce::LocalisedStrings::translateWithCurrentMappings (node.getProperty (propGroupText).toString()));
-            }
-            if (node.hasProperty (propGroupJustification)) {
-                group->setTextLabelPosition (juce::Justification (node.getProperty (propGroupJustification)));
-            }
-            owningComponent->addAndMakeVisible(group);
-            item.setComponent (group, true);
+            realizeOwnedComponent (node, owningComponent, layout);
         }
         for (int i=0; i < node.getNumChildren(); ++i) {
             juce::ValueTree child = node.getChild (i);
@@ -706,383 +737,101 @@ void LayoutItem::realize (juce::ValueTree& node, juce::Component* owningComponen
     }
 }
 
-
-int LayoutItem::updateGeometry (juce::ValueTree& node, juce::Rectangle<int> bounds)
+void LayoutItem::realizeOwnedComponent (juce::ValueTree& node, juce::Component* owningComponent, Layout* layout)
 {
-    int needsGrowing = 0;
-    
-    if (node.getType() == itemTypeSubLayout) {
-        LayoutItem layout (node);
-        const Orientation orientation = layout.getOrientation();
-        
-        // find splitter items
-        int last = 0;
-        juce::Rectangle<int> childBounds (bounds);
-        for (int i=0; i<node.getNumChildren(); ++i) {
-            juce::ValueTree childNode = node.getChild (i);
-            LayoutItem item (childNode);
-            if (item.isOverlay() < 1) {
-                if (childNode.getType() == itemTypeSplitter) {
-                    LayoutSplitter splitter (childNode);
-                    juce::Rectangle<int> splitterBounds (bounds);
-                    
-                    // calculate minimum and maximum splitter positions
-                    int leftMinW = -1;
-                    int leftMaxW = -1;
-                    int leftMinH = -1;
-                    int leftMaxH = -1;
-                    getSizeLimits (node, leftMinW, leftMaxW, leftMinH, leftMaxH, last, i);
-                    int rightMinW = -1;
-                    int rightMaxW = -1;
-                    int rightMinH = -1;
-                    int rightMaxH = -1;
-                    getSizeLimits (node, rightMinW, rightMaxW, rightMinH, rightMaxH, i, node.getNumChildren());
-                    
-                    if (orientation == LayoutItem::LeftToRight) {
-                        if (bounds.getWidth() > 0) {
-                            float relPosition = splitter.getRelativePosition();
-                            float minRelPosition = static_cast<float>(leftMinW) / bounds.getWidth();
-                            float maxRelPosition = 1.0 - static_cast<float>(rightMinW) / bounds.getWidth();
-                            if (relPosition < minRelPosition) {
-                                splitter.setRelativePosition (minRelPosition);
-                            }
-                            else if (relPosition > maxRelPosition) {
-                                splitter.setRelativePosition (maxRelPosition);
-                            }
-                        }
-                        int right = childBounds.getX() + splitter.getRelativePosition() * bounds.getWidth();
-                        updateGeometry (node, childBounds.withRight (right-1), last, i);
-                        splitterBounds.setX (right-1);
-                        splitterBounds.setWidth (3);
-                        childBounds.setLeft (right+1);
-                    }
-                    else if (orientation == LayoutItem::TopDown) {
-                        if (bounds.getWidth() > 0) {
-                            float relPosition = splitter.getRelativePosition();
-                            float minRelPosition = static_cast<float>(leftMinH) / bounds.getWidth();
-                            float maxRelPosition = 1.0 - static_cast<float>(rightMinH) / bounds.getWidth();
-                            if (relPosition < minRelPosition) {
-                                splitter.setRelativePosition (minRelPosition);
-                            }
-                            else if (relPosition > maxRelPosition) {
-                                splitter.setRelativePosition (maxRelPosition);
-                            }
-                        }
-                        int bottom = childBounds.getY() + splitter.getRelativePosition() * bounds.getHeight();
-                        updateGeometry (node, childBounds.withBottom (bottom), last, i);
-                        splitterBounds.setY (bottom-1);
-                        splitterBounds.setHeight (3);
-                        childBounds.setTop (bottom+1);
-                    }
-                    else if (orientation == LayoutItem::RightToLeft) {
-                        if (bounds.getWidth() > 0) {
-                            float relPosition = splitter.getRelativePosition();
-                            float minRelPosition = 1.0 - static_cast<float>(leftMinW) / bounds.getWidth();
-                            float maxRelPosition = static_cast<float>(rightMinW) / bounds.getWidth();
-                            if (relPosition < minRelPosition) {
-                                splitter.setRelativePosition (minRelPosition);
-                            }
-                            else if (relPosition > maxRelPosition) {
-                                splitter.setRelativePosition (maxRelPosition);
-                            }
-                        }
-                        int left = childBounds.getX() + splitter.getRelativePosition() * bounds.getWidth();
-                        updateGeometry (node, childBounds.withLeft (left), last, i);
-                        splitterBounds.setX (left-1);
-                        splitterBounds.setWidth (3);
-                        childBounds.setRight (left-1);
-                    }
-                    else if (orientation == LayoutItem::BottomUp) {
-                        if (bounds.getWidth() > 0) {
-                            float relPosition = splitter.getRelativePosition();
-                            float minRelPosition = 1.0 - static_cast<float>(leftMinH) / bounds.getWidth();
-                            float maxRelPosition = static_cast<float>(rightMinH) / bounds.getWidth();
-                            if (relPosition < minRelPosition) {
-                                splitter.setRelativePosition (minRelPosition);
-                            }
-                            else if (relPosition > maxRelPosition) {
-                                splitter.setRelativePosition (maxRelPosition);
-                            }
-                        }
-
-                        int top = childBounds.getY() + splitter.getRelativePosition() * bounds.getHeight();
-                        updateGeometry (node, childBounds.withTop (top), last, i);
-                        splitterBounds.setY (top-1);
-                        splitterBounds.setHeight (3);
-                        childBounds.setBottom (top-1);
-                    }
-                    splitter.setItemBounds (splitterBounds);
-                    splitter.setBounds (splitterBounds);
-                    splitter.setBoundsAreFinal (true);
-                    
-                    i++;
-                    last = i;
-                }
-            }
-        }
-        
-        // layout rest right of splitter, if any
-        updateGeometry (node, childBounds, last, node.getNumChildren());
+    if (layout && layout->isCreatingComponentsLazily()) {
+        // the plan creates the component, when the item gets bounds
+        SharedLayoutData* data = getOrCreateData (node);
+        data->ownedComponent = nullptr;
+        data->componentPtr   = nullptr;
+        data->createComponentLazily = true;
+        return;
     }
-    else {
-        // give the chance to respect aspectRatio constraint - depends on given size
-        juce::Rectangle<int> childBounds (bounds);
-        LayoutItem item (node);
-        LayoutItem parent (node.getParent());
-        bool changedWidth, changedHeight;
-        item.constrainBounds (childBounds, changedWidth, changedHeight, parent.isVertical());
+    if (SharedLayoutData* data = getSharedData (node)) {
+        data->createComponentLazily = false;
     }
-    return needsGrowing;
+    createOwnedComponent (node, owningComponent, layout);
 }
 
-int LayoutItem::updateGeometry (juce::ValueTree& node, juce::Rectangle<int> bounds, int start, int end)
+juce::Component* LayoutItem::createOwnedComponent (juce::ValueTree& node, juce::Component* owningComponent, Layout* layout)
 {
-    LayoutItem layout (node);
-    int needsGrowing = 0;
-    
-    // recursion check
-    if (node.getProperty (volatileIsUpdating, false)) {
-        return 0;
+    if (owningComponent == nullptr) {
+        return nullptr;
     }
-    node.setProperty (volatileIsUpdating, true, nullptr);
-    
-    float cummulatedX, cummulatedY;
-    LayoutItem::getStretch (node, cummulatedX, cummulatedY, start, end);
-    float availableWidth  = bounds.getWidth();
-    float availableHeight = bounds.getHeight();
-    const Orientation orientation = layout.getOrientation();
-    
-    if (layout.isVertical()) {
-        for (int i=start; i<juce::jmin (node.getNumChildren(), end); ++i) {
-            juce::ValueTree child (node.getChild (i));
-            LayoutItem item (child);
-            int overlay = item.isOverlay();
-            if (overlay < 1) {
-                float sx, sy;
-                LayoutItem::getStretch (child, sx, sy);
-
-                float h = bounds.getHeight() * sy / cummulatedY;
-                juce::Rectangle<int> childBounds (bounds.getX(), bounds.getY(), bounds.getWidth(), h);
-                bool changedWidth, changedHeight;
-                item.constrainBounds (childBounds, changedWidth, changedHeight, true);
-                item.setItemBounds (childBounds);
-                if (changedHeight) {
-                    item.setBoundsAreFinal (true);
-                    availableHeight -= childBounds.getHeight();
-                    cummulatedY -= sy;
-                }
-                else {
-                    item.setBoundsAreFinal (false);
-                }
-                if (changedWidth) {
-                    availableWidth = std::max (bounds.getWidth(), childBounds.getWidth());
-                }
-            }
+
+    LayoutItem item (node);
+    juce::Component* component = nullptr;
+    if (node.getType() == itemTypeComponent && node.hasProperty (propLabelText)) {
+        juce::Label* newLabel = new juce::Label();
+        newLabel->setText (juce::LocalisedStrings::translateWithCurrentMappings (node.getProperty (propLabelText).toString()), juce::dontSendNotification);
+        if (node.hasProperty (propLabelFontSize)) {
+            newLabel->setFont (juce::Font (node.getProperty (propLabelFontSize), 12.0));
         }
-        needsGrowing = std::max (static_cast<int>(-availableHeight), 0);
-        
-        float y = bounds.getY();
-        if (orientation == BottomUp) {
-            y = bounds.getY() + bounds.getHeight();
+        if (node.hasProperty (propLabelJustification)) {
+            newLabel->setJustificationType (juce::Justification (node.getProperty (propLabelJustification, 36)));
         }
-        for (int i=start; i<juce::jmin (node.getNumChildren(), end); ++i) {
-            juce::ValueTree child = node.getChild (i);
-            LayoutItem item (child);
-            
-            if (item.isOverlay() == 0) {
-                if (item.getBoundsAreFinal()) {
-                    float h = item.getItemBounds().getHeight();
-                    if (orientation == BottomUp) {
-                        y -= h;
-                    }
-                    item.setItemBounds (bounds.getX(), y, availableWidth, h);
-                    if (child.getType() == itemTypeSubLayout) {
-                        LayoutItem::updateGeometry (child, item.getPaddedItemBounds());
-                        if (juce::Component* c = item.getComponent()) {
-                            // component in a layout is a GroupComponent, so don't pad component but contents
-                            c->setBounds (item.getItemBounds());
-                        }
-                    }
-                    else if (juce::Component* c = item.getComponent()) {
-                        c->setBounds (item.getPaddedItemBounds());
-                    }
-                    
-                    if (orientation == TopDown) {
-                        y += h;
-                    }
-                }
-                else {
-                    float sx, sy;
-                    LayoutItem::getStretch (child, sx, sy);
-                    
-                    float h = availableHeight * sy /cummulatedY;
-                    if (orientation == BottomUp) {
-                        y -= h;
-                    }
-                    item.setItemBounds (bounds.getX(), y, availableWidth, h );
-                    if (child.getType() == itemTypeSubLayout) {
-                        LayoutItem sub (child);
-                        sub.updateGeometry (child, item.getPaddedItemBounds());
-                        if (juce::Component* c = item.getComponent()) {
-                            // component in a layout is a GroupComponent, so don't pad component but contents
-                            c->setBounds (item.getItemBounds());
-                        }
-                    }
-                    else if (juce::Component* c = item.getComponent()) {
-                        c->setBounds (item.getPaddedItemBounds());
-                    }
-                    item.callListenersCallback (item.getPaddedItemBounds());
-                    if (orientation == TopDown) {
-                        y += h;
-                    }
-                }
-            }
-            else {
-                // overlay other item
-                juce::Rectangle<int> overlayTarget;
-                if (item.isOverlay() == 1 && i > start) {
-                    LayoutItem previous (node.getChild(i-1));
-                    overlayTarget = previous.getItemBounds();
-                }
-                else if (item.isOverlay() == 2) {
-                    overlayTarget = bounds;
-                }
-                juce::Rectangle<int> overlayBounds (0, 0, item.getOverlayWidth() * overlayTarget.getWidth(), item.getOverlayHeight() * overlayTarget.getHeight());
-                bool changedWidth, changedHeight;
-                item.constrainBounds (overlayBounds, changedWidth, changedHeight, true);
-                juce::Justification j (item.getOverlayJustification());
-                item.setItemBounds (j.appliedToRectangle (overlayBounds, overlayTarget));
-                if (child.getType() == itemTypeSubLayout) {
-                    LayoutItem::updateGeometry (child, item.getPaddedItemBounds());
-                    if (juce::Component* c = item.getComponent()) {
-                        // component in a layout is a GroupComponent, so don't pad component but contents
-                        c->setBounds (item.getItemBounds());
-                    }
-                }
-                else if (juce::Component* c = item.getComponent()) {
-                    c->setBounds (item.getPaddedItemBounds());
-                }
-                item.callListenersCallback (item.getPaddedItemBounds());
-                
-            }
+        if (node.hasProperty (propComponentName)) {
+            newLabel->setName (node.getProperty (propComponentName).toString());
         }
-    } else if (layout.isHorizontal()) {
-        for (int i=start; i<juce::jmin (node.getNumChildren(), end); ++i) {
-            juce::ValueTree child (node.getChild (i));
-            LayoutItem item (child);
-            int overlay = item.isOverlay();
-            if (overlay < 1) {
-                float sx, sy;
-                LayoutItem::getStretch (child, sx, sy);
-
-                float w = bounds.getWidth() * sx / cummulatedX;
-                juce::Rectangle<int> childBounds (bounds.getX(), bounds.getY(), w, bounds.getHeight());
-                bool changedWidth, changedHeight;
-                item.constrainBounds (childBounds, changedWidth, changedHeight, false);
-                item.setItemBounds (childBounds);
-                if (changedWidth) {
-                    item.setBoundsAreFinal (true);
-                    availableWidth -= childBounds.getWidth();
-                    cummulatedX -= sx;
-                }
-                else {
-                    item.setBoundsAreFinal (false);
-                }
-                if (changedHeight) {
-                    availableHeight = std::max (bounds.getHeight(), childBounds.getHeight());
-                }
-            }
+        if (node.hasProperty (propComponentID)) {
+            newLabel->setComponentID (node.getProperty (propComponentID).toString());
         }
-        needsGrowing = std::max (static_cast<int>(-availableWidth), 0);
-
-        float x = bounds.getX();
-        if (orientation == RightToLeft) {
-            x = bounds.getX() + bounds.getWidth();
+        component = newLabel;
+    }
+    else if (node.getType() == itemTypeSplitter) {
+        LayoutSplitter::Component* splitterComponent = new LayoutSplitter::Component (layout);
+        if (node.hasProperty (propComponentID)) {
+            splitterComponent->setComponentID (node.getProperty (propComponentID).toString());
         }
-        for (int i=start; i<juce::jmin (node.getNumChildren(), end); ++i) {
-            juce::ValueTree child = node.getChild (i);
-            LayoutItem item (child);
-            if (item.isOverlay() < 1) {
-                if (item.getBoundsAreFinal()) {
-                    float w = item.getItemBounds().getWidth();
-                    if (orientation == RightToLeft) {
-                        x -= w;
-                    }
-                    item.setItemBounds (x, bounds.getY(), w, availableHeight);
-                    juce::Rectangle<int> childBounds (x, bounds.getY(), w, availableHeight);
-                    if (child.getType() == itemTypeSubLayout) {
-                        LayoutItem::updateGeometry (child, item.getPaddedItemBounds());
-                        if (juce::Component* c = item.getComponent()) {
-                            // component in a layout is a GroupComponent, so don't pad component but contents
-                            c->setBounds (item.getItemBounds());
-                        }
-                    }
-                    else if (juce::Component* c = item.getComponent()) {
-                        c->setBounds (item.getPaddedItemBounds());
-                    }
-                    
-                    if (orientation == LeftToRight) {
-                        x += w;
-                    }
-                }
-                else {
-                    float sx, sy;
-                    LayoutItem::getStretch (child, sx, sy);
+        if (LayoutItem (node.getParent()).isHorizontal()) {
+            splitterComponent->setMouseCursor (juce::MouseCursor::LeftRightResizeCursor);
+        }
+        else {
+            splitterComponent->setMouseCursor (juce::MouseCursor::UpDownResizeCursor);
+        }
+        component = splitterComponent;
+    }
+    else if (node.getType() == itemTypeSubLayout && (node.hasProperty (propGroupName) || node.hasProperty (propGroupText))) {
+        juce::GroupComponent* group = new juce::GroupComponent();
+        if (node.hasProperty (propGroupName)) {
+            group->setName (node.getProperty (propGroupName).toString());
+        }
+        if (node.hasProperty (propGroupText)) {
+            group->setText (juce::LocalisedStrings::translateWithCurrentMappings (node.getProperty (propGroupText).toString()));
+        }
+        if (node.hasProperty (propGroupJustification)) {
+            group->setTextLabelPosition (juce::Justification (node.getProperty (propGroupJustification)));
+        }
+        component = group;
+    }
 
-                    float w = availableWidth * sx /cummulatedX;
-                    if (orientation == RightToLeft) {
-                        x -= w;
-                    }
-                    item.setItemBounds (x, bounds.getY(), w, availableHeight);
-                    if (child.getType() == itemTypeSubLayout) {
-                        LayoutItem::updateGeometry (child, item.getPaddedItemBounds());
-                        if (juce::Component* c = item.getComponent()) {
-                            // component in a layout is a GroupComponent, so don't pad component but contents
-                            c->setBounds (item.getItemBounds());
-                        }
-                    }
-                    else if (juce::Component* c = item.getComponent()) {
-                        c->setBounds (item.getPaddedItemBounds());
-                    }
-                    item.callListenersCallback (item.getPaddedItemBounds());
-                    if (orientation == LeftToRight) {
-                        x += w;
-                    }
-                }
-            }
-            else {
-                // overlay other item
-                juce::Rectangle<int> overlayTarget;
-                if (item.isOverlay() == 1 && i > start) {
-                    LayoutItem previous (node.getChild(i-1));
-                    overlayTarget = previous.getItemBounds();
-                }
-                else if (item.isOverlay() == 2) {
-                    overlayTarget = bounds;
-                }
-                juce::Rectangle<int> overlayBounds (0, 0, item.getOverlayWidth() * overlayTarget.getWidth(), item.getOverlayHeight() * overlayTarget.getHeight());
-                bool changedWidth, changedHeight;
-                item.constrainBounds (overlayBounds, changedWidth, changedHeight, true);
-                juce::Justification j (item.getOverlayJustification());
-                item.setItemBounds (j.appliedToRectangle (overlayBounds, overlayTarget));
-                if (child.getType() == itemTypeSubLayout) {
-                    LayoutItem sub (child);
-                    sub.updateGeometry (child, item.getPaddedItemBounds());
-                    if (juce::Component* c = item.getComponent()) {
-                        // component in a layout is a GroupComponent, so don't pad component but contents
-                        c->setBounds (item.getItemBounds());
-                    }
-                }
-                else if (juce::Component* c = item.getComponent()) {
-                    c->setBounds (item.getPaddedItemBounds());
-                }
-                item.callListenersCallback (item.getPaddedItemBounds());
-                
-            }
+    if (component) {
+        owningComponent->addAndMakeVisible (component);
+        item.setComponent (component, true);
+        if (layout) {
+            layout->addChildToLookup (owningComponent, component);
+            layout->addComponentToIndex (node, component);
         }
     }
-    
-    node.setProperty (volatileIsUpdating, false, nullptr);
+    return component;
+}
+
+
+int LayoutItem::updateGeometry (juce::ValueTree& node, juce::Rectangle<int> bounds)
+{
+    LayoutPlan plan;
+    plan.compile (node);
+    plan.solve (bounds);
+    plan.apply ();
+    return 0;
+}
+
+int LayoutItem::updateGeometry (juce::ValueTree& node, juce::Rectangle<int> bounds, int start, int end)
+{
+    LayoutPlan plan;
+    plan.compile (node);
+    const int needsGrowing = plan.solve (0, bounds, start, end);
+    plan.apply ();
     return needsGrowing;
 }
 
@@ -1276,14 +1025,17 @@ void LayoutItem::removeListener (LayoutItemListener* const listener)
 
 void LayoutItem::callListenersCallback (juce::Rectangle<int> newBounds)
 {
-    SharedLayoutData* data = getOrCreateData (state);
-    data->callListenersCallback (state, newBounds);
+    // without data there can't be any listeners, so don't create it
+    if (SharedLayoutData* data = getSharedData (state)) {
+        data->callListenersCallback (state, newBounds);
+    }
 }
 
 void LayoutItem::callListenersCallback (float relativePosition, bool final)
 {
-    SharedLayoutData* data = getOrCreateData (state);
-    data->callListenersCallback (state, relativePosition, final);
+    if (SharedLayoutData* data = getSharedData (state)) {
+        data->callListenersCallback (state, relativePosition, final);
+    }
 }
 
 //==============================================================================
@@ -1361,6 +1113,9 @@ void LayoutSplitter::Component::mouseDrag (const juce::MouseEvent &event)
     if (layoutPtr) {
         juce::ValueTree item = layoutPtr->getLayoutItem (this);
         if (item.isValid()) {
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+            const LayoutTraceRecorder::ScopedSpan dragSpan (layoutPtr->getTraceRecorder(), item, "splitter");
+#endif
             juce::ValueTree parentNode (item.getParent());
             LayoutSplitter  splitter (item);
             LayoutItem      parent   (parentNode);
@@ -1371,8 +1126,9 @@ void LayoutSplitter::Component::mouseDrag (const juce::MouseEvent &event)
                 juce::Rectangle<int> layoutBounds (parentComponent->getLocalBounds());
                 
                 horizontal = parent.isHorizontal();
-                if (!parent.getItemBounds().isEmpty()) {
-                    layoutBounds = parent.getItemBounds();
+                const juce::Rectangle<int> parentBounds = layoutPtr->getItemBounds (parentNode);
+                if (!parentBounds.isEmpty()) {
+                    layoutBounds = parentBounds;
                 }
                 if (horizontal) {
                     pos = (event.getEventRelativeTo(parentComponent).position.getX() - layoutBounds.getX()) / layoutBounds.getWidth();
@@ -1383,7 +1139,7 @@ void LayoutSplitter::Component::mouseDrag (const juce::MouseEvent &event)
                 splitter.setRelativePosition (juce::jmax (splitter.getMinimumRelativePosition(), juce::jmin (splitter.getMaximumRelativePosition(), pos)));
                 
                 layoutPtr->updateGeometry();
-                splitter.callListenersCallback (splitter.getRelativePosition(), false);
+                layoutPtr->callSplitterListenersAfterUpdate (item);
             }
         }
     }
@@ -1394,6 +1150,8 @@ void LayoutSplitter::Component::mouseUp (const juce::MouseEvent& event)
     if (layoutPtr) {
         juce::ValueTree item = layoutPtr->getLayoutItem (this);
         if (item.isValid()) {
+            // report the final position only after it was clamped by the update
+            layoutPtr->flush();
             LayoutSplitter  splitter (item);
             if (splitter.isValid()) {
                 splitter.callListenersCallback (splitter.getRelativePosition(), true);
@@ -43,6 +43,7 @@
 #include "juce_gui_basics/juce_gui_basics.h"
 
 class Layout;
+class LayoutPlan;
 class LayoutSplitter;
 
 //==============================================================================
@@ -82,6 +83,13 @@ public:
          to find it as child of the \p owningComponent.
          */
         virtual void layoutSplitterMoved (juce::ValueTree item, float relativePos, bool final) {}
+
+        /**
+         Callback on the listeners of the root item of a Layout, once per update with all
+         items, whose bounds changed in that update. Override this to handle all changes
+         at once instead of adding a listener to each item.
+         */
+        virtual void layoutItemsChanged (juce::ValueTree root, const juce::Array<juce::ValueTree>& changedItems) {}
         
     };
 
@@ -95,6 +103,7 @@ private:
         
     private:
         friend LayoutItem;
+        friend LayoutPlan;
         
         /** @internal */
         const juce::Component* getComponent() const;
@@ -129,8 +138,36 @@ private:
         juce::ScopedPointer<juce::Component>            ownedComponent;
         
         juce::ListenerList<Listener> layoutItemListeners;
+
+        /** The bounds computed by the last updateGeometry */
+        juce::Rectangle<int>                            itemBounds;
+
+        /** Set, if the bounds were constrained by the size limits in the last updateGeometry */
+        bool                                            boundsAreFinal = false;
+
+        /** The index of the item in the LayoutPlan of the owning Layout, used as lookup hint */
+        int                                             planIndex = -1;
+
+        /** Set, if the owned component is created when the item gets bounds, @see Layout::setLazyComponentCreation */
+        bool                                            createComponentLazily = false;
+
+        /** The padded bounds the listeners were called with last, so unchanged bounds are not reported again */
+        juce::Rectangle<int>                            listenerBounds;
     };
 
+    /**
+     Returns the shared layout data of node or nullptr, if none was created yet
+     */
+    static SharedLayoutData* getSharedData (const juce::ValueTree& node);
+
+    /**
+     Creates the owned component of node now, or marks it to be created when the
+     item gets bounds, if the layout creates components lazily
+     */
+    static void realizeOwnedComponent (juce::ValueTree& node, juce::Component* owningComponent, Layout* layout);
+
+    friend LayoutPlan;
+
 
 public:
     enum ItemType {
@@ -149,7 +186,8 @@ public:
         TopDown,
         RightToLeft,
         BottomUp,
-        //GridLayout
+        GridLayout,
+        FlowLayout
     };
     
     /**
@@ -181,6 +219,9 @@ public:
      @see isHorizontal and @see isVertival
      */
     Orientation getOrientation () const;
+
+    /** Returns true, if the item is a sub layout arranging its children in a grid */
+    bool isGrid () const;
     
     static Orientation getOrientationFromName (juce::Identifier name);
     
@@ -249,6 +290,8 @@ public:
     
     /**
      Get or create a shared layout data blob for state node. @see SharedLayoutData
+     The data holds all state computed by the layout. It is attached to the node once
+     and never recorded by the UndoManager, so the undo parameter is ignored.
      */
     static LayoutItem::SharedLayoutData* getOrCreateData (juce::ValueTree& node, juce::UndoManager* undo=nullptr);
 
@@ -473,8 +516,23 @@ public:
     void constrainBounds (juce::Rectangle<int>& bounds, bool& changedWidth, bool& changedHeight, bool preferVertical);
 
     /**
-     This property is dynamically calculated each time updateGeometry is called.
-     Setting this property on the root node lets you place the layout on a fixed
+     Applies the given size constraints to bounds. A negative or zero limit means no constraint.
+     @see constrainBounds
+     */
+    static void constrainBounds (juce::Rectangle<int>& bounds, bool& changedWidth, bool& changedHeight, bool preferVertical,
+                                 int minWidth, int maxWidth, int minHeight, int maxHeight, float aspectRatio);
+
+    /**
+     Creates the component the item owns, i.e. the Label for a \p labelText, the GroupComponent
+     for a \p groupText or the LayoutSplitter::Component, adds it to owningComponent and sets
+     it to the item. Returns nullptr, if the item doesn't own a component.
+     */
+    static juce::Component* createOwnedComponent (juce::ValueTree& node, juce::Component* owningComponent, Layout* layout);
+
+    /**
+     The bounds are dynamically calculated each time updateGeometry is called and
+     kept in the item's SharedLayoutData, they are not stored as property.
+     Setting the bounds on the root node lets you place the layout on a fixed
      position in the owningComponent. If it is set empty (i.e. size equals 0, 0)
      which is the default, the local bounds of the owningComponent are used as
      available space.
@@ -490,7 +548,16 @@ public:
     /**
      returns the calculated bounds of the item or layout.
      Calling this on the root node returns only a valid rectangle, if it was set
-     as fixed bounds.
+     as fixed bounds. A Layout stores the bounds only in items with listeners or
+     components. Spacers, lines and sub layouts without a listener return an empty
+     rectangle.
+
+     Migration: code that read the bounds of those items from the tree, e.g. to draw
+     decorations around a sub layout, has to ask the Layout instead:
+     \code{.cpp}
+     juce::Rectangle<int> bounds = myLayout.getItemBounds (node);
+     \endcode
+     @see Layout::getItemBounds
      */
     juce::Rectangle<int> getItemBounds() const;
 
@@ -501,7 +568,9 @@ public:
 
     /**
      set the flag that the bounds are adapted with size limits and shall not change
-     This is computed on each updateGeometry and should not be set
+     This is computed on each updateGeometry and should not be set.
+     Like the bounds it is kept in the SharedLayoutData, so setting it doesn't notify
+     any ValueTree::Listener.
      */
     void setBoundsAreFinal (bool final);
 
@@ -512,13 +581,23 @@ public:
      */
     bool getBoundsAreFinal() const;
     
+    /**
+     Returns true for properties, which are used by the layout internally and are
+     not part of the layout definition. Use this in a ValueTree::Listener to ignore
+     those changes.
+     */
+    static bool isTransientProperty (const juce::Identifier& property);
+
     /** Set the wrapped components componentID and the item's componentID property */
     void setWrappedComponentID (const juce::String& name, bool setComp);
 
     /**
-     paint the bounds of the item and sub items for debugging
+     paint the bounds of the item and sub items for debugging. The bounds are read
+     from the layout, because not every item stores them in the tree.
+     Migration: this used to be called without the layout, pass the Layout that
+     solves node, or call Layout::paintBounds to paint the whole tree.
      */
-    static void paintBounds (const juce::ValueTree& node, juce::Graphics& g);
+    static void paintBounds (const Layout& layout, const juce::ValueTree& node, juce::Graphics& g);
     
     /**
      Chance for LayoutItems to fix properties that might have changed for saving
@@ -532,11 +611,16 @@ public:
     
     /**
      Recompute the geometry of all components. Recoursively recomputes all sub layouts.
+     This compiles a temporary LayoutPlan, so prefer Layout::updateGeometry for repeated updates.
+     @see LayoutPlan
      */
     static int updateGeometry (juce::ValueTree& node, juce::Rectangle<int> bounds);
     
     /**
      Recompute the geometry of all components. Recoursively recomputes all sub layouts.
+     This compiles a temporary LayoutPlan, so prefer Layout::updateGeometry for repeated updates.
+     Returns the number of pixels the items from start to end would need in addition to fit.
+     @see LayoutPlan
      */
     static int updateGeometry (juce::ValueTree& node, juce::Rectangle<int> bounds, int start, int end);
     
@@ -596,6 +680,8 @@ public:
     static const juce::Identifier orientationTopDown;
     static const juce::Identifier orientationRightToLeft;
     static const juce::Identifier orientationBottomUp;
+    static const juce::Identifier orientationGrid;
+    static const juce::Identifier orientationFlow;
 
     static const juce::Identifier propStretchX;
     static const juce::Identifier propStretchY;
@@ -616,6 +702,14 @@ public:
     static const juce::Identifier propOverlayHeight;
     static const juce::Identifier propOverlayJustification;
 
+    static const juce::Identifier propGridColumns;
+    static const juce::Identifier propGridRows;
+    static const juce::Identifier propGridColumn;
+    static const juce::Identifier propGridRow;
+    static const juce::Identifier propGridColumnSpan;
+    static const juce::Identifier propGridRowSpan;
+    static const juce::Identifier propVirtual;
+
     static const juce::Identifier propComponentID;
     static const juce::Identifier propComponentName;
     static const juce::Identifier propLabelText;
@@ -629,9 +723,6 @@ private:
     JUCE_LEAK_DETECTOR (LayoutItem)
 
     static const juce::Identifier volatileSharedLayoutData;
-    static const juce::Identifier volatileItemBounds;
-    static const juce::Identifier volatileItemBoundsFixed;
-    static const juce::Identifier volatileIsUpdating;
     
 
 };
@@ -0,0 +1,1692 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutPlan.cpp
+    Created: 16 Oct 2026 10:12:31am
+
+  ==============================================================================
+*/
+
+
+#include "ff_layout.h"
+
+LayoutPlan::LayoutPlan ()
+  : compiled (false),
+    solved (false),
+    containsVirtualLists (false),
+    numDirty (0),
+    lazyComponentOwner (nullptr),
+    lazyComponentLayout (nullptr),
+    releaseCollapsedComponents (false),
+    integerDistribution (false)
+{
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    childTicks    = 0;
+    traceRecorder = nullptr;
+#endif
+}
+
+LayoutPlan::~LayoutPlan ()
+{
+}
+
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+
+/** Measures one solveNode call, the time of the nested calls is left out of the exclusive time */
+class LayoutPlan::ScopedSolveTimer
+{
+public:
+    ScopedSolveTimer (LayoutPlan& planToMeasure, int indexToMeasure)
+      : plan (planToMeasure),
+        index (indexToMeasure),
+        outerChildTicks (planToMeasure.childTicks),
+        startTicks (juce::Time::getHighResolutionTicks())
+    {
+        plan.childTicks = 0;
+    }
+
+    ~ScopedSolveTimer ()
+    {
+        const juce::int64 elapsed = juce::Time::getHighResolutionTicks() - startTicks;
+        LayoutNodeStats& stats = plan.nodeStats.getReference (index);
+        ++stats.numSolves;
+        stats.inclusiveTicks += elapsed;
+        stats.exclusiveTicks += elapsed - plan.childTicks;
+        plan.childTicks = outerChildTicks + elapsed;
+    }
+
+private:
+    LayoutPlan&         plan;
+    const int           index;
+    const juce::int64   outerChildTicks;
+    const juce::int64   startTicks;
+
+    JUCE_DECLARE_NON_COPYABLE (ScopedSolveTimer)
+};
+
+#endif // FF_LAYOUT_ENABLE_INSTRUMENTATION
+
+void LayoutPlan::clear ()
+{
+    compiled = false;
+    solved   = false;
+    numDirty = 0;
+    dirty.clearQuick();
+    movedSplitters.clearQuick();
+    nodes.clearQuick();
+    sharedData.clearQuick();
+    parents.clearQuick();
+    firstChildren.clearQuick();
+    numChildren.clearQuick();
+    types.clearQuick();
+    orientations.clearQuick();
+    stretchX.clearQuick();
+    stretchY.clearQuick();
+    minWidths.clearQuick();
+    maxWidths.clearQuick();
+    minHeights.clearQuick();
+    maxHeights.clearQuick();
+    aspectRatios.clearQuick();
+    paddingTops.clearQuick();
+    paddingLefts.clearQuick();
+    paddingRights.clearQuick();
+    paddingBottoms.clearQuick();
+    overlays.clearQuick();
+    overlayWidths.clearQuick();
+    overlayHeights.clearQuick();
+    overlayJustifications.clearQuick();
+    relativePositions.clearQuick();
+    gridColumns.clearQuick();
+    gridRows.clearQuick();
+    gridCells.clearQuick();
+    flowStates.clearQuick();
+    flexSizes.clearQuick();
+    remainderOrder.clearQuick();
+    changedItems.clearQuick();
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    nodeStats.clearQuick();
+    nodePaths.clearQuick();
+#endif
+    virtualLists.clearQuick();
+    containsVirtualLists = false;
+    visibleStarts.clearQuick();
+    visibleEnds.clearQuick();
+    virtualOffsets.clearQuick();
+    aggregatesValid.clearQuick();
+    totalStretchX.clearQuick();
+    totalStretchY.clearQuick();
+    remainingMinWidths.clearQuick();
+    remainingMinHeights.clearQuick();
+    itemBounds.clearQuick();
+    boundsAreFinal.clearQuick();
+    notifyListeners.clearQuick();
+    solvedItems.clearQuick();
+    isSolvedItem.clearQuick();
+}
+
+bool LayoutPlan::isCompiled () const
+{
+    return compiled;
+}
+
+int LayoutPlan::getNumItems () const
+{
+    return nodes.size();
+}
+
+juce::ValueTree LayoutPlan::getNode (int index) const
+{
+    return nodes [index];
+}
+
+int LayoutPlan::indexOf (const juce::ValueTree& node) const
+{
+    if (LayoutItem::SharedLayoutData* data = LayoutItem::getSharedData (node)) {
+        const int index = data->planIndex;
+        // the hint may be left from a previous compile, so check it
+        if (juce::isPositiveAndBelow (index, nodes.size()) && nodes.getReference (index) == node) {
+            return index;
+        }
+    }
+    if (nodes.isEmpty() || ! node.isValid()) {
+        return -1;
+    }
+    if (node == nodes.getReference (0)) {
+        return 0;
+    }
+    // the children of a node are compiled next to each other, so step from the parent
+    const juce::ValueTree parent = node.getParent();
+    const int parentIndex = indexOf (parent);
+    if (parentIndex < 0) {
+        return -1;
+    }
+    const int i = parent.indexOf (node);
+    if (! juce::isPositiveAndBelow (i, numChildren.getUnchecked (parentIndex))) {
+        return -1;
+    }
+    const int index = firstChildren.getUnchecked (parentIndex) + i;
+    return nodes.getReference (index) == node ? index : -1;
+}
+
+void LayoutPlan::updateSharedData (const juce::ValueTree& node)
+{
+    const int index = indexOf (node);
+    LayoutItem::SharedLayoutData* data = LayoutItem::getSharedData (node);
+    if (index < 0 || data == nullptr || sharedData.getReference (index) == data) {
+        return;
+    }
+    if (const LayoutItem::SharedLayoutData* previous = sharedData.getReference (index)) {
+        data->itemBounds     = previous->itemBounds;
+        data->boundsAreFinal = previous->boundsAreFinal;
+        // listenerBounds are left empty, so new listeners get the bounds with the next update
+    }
+    data->planIndex = index;
+    sharedData.set (index, data);
+}
+
+bool LayoutPlan::updateProperties (const juce::ValueTree& node, const juce::Identifier& property)
+{
+    if (! compiled) {
+        return false;
+    }
+    const int index = indexOf (node);
+    if (index < 0) {
+        return false;
+    }
+    readProperties (index);
+    invalidateAggregates (index);
+
+    // the parent reads only the item's own properties, so the change affects the distribution
+    // further up only through the implicit stretch. The root has no parent and is solved as a whole.
+    const int parent = parents.getUnchecked (index);
+    if (isGrid (index)) {
+        placeGridCells (index);
+    }
+    if (parent >= 0 && isGrid (parent)) {
+        placeGridCells (parent);
+    }
+    invalidateFlow (index);
+    if (parent >= 0) {
+        invalidateFlow (parent, index - firstChildren.getUnchecked (parent));
+    }
+    if (parent < 0) {
+        markDirty (index, Changed);
+    }
+    else if (types.getUnchecked (index) == LayoutItem::SplitterItem && property == LayoutSplitter::propRelativePosition) {
+        // a moved splitter only changes the items on either side
+        movedSplitters.set (index, true);
+        markDirty (parent, SplittersMoved);
+    }
+    else {
+        markDirty (affectsImplicitStretch (property) ? getHighestImplicitStretchAncestor (parent) : parent, Changed);
+    }
+    return true;
+}
+
+bool LayoutPlan::affectsImplicitStretch (const juce::Identifier& property)
+{
+    return ! property.isValid()
+        || property == LayoutItem::propStretchX
+        || property == LayoutItem::propStretchY
+        || property == LayoutItem::propOrientation
+        || property == LayoutItem::propOverlay;
+}
+
+int LayoutPlan::getHighestImplicitStretchAncestor (int index) const
+{
+    // a sub layout without explicit stretch passes the stretch of its children on to its
+    // own parent, so the distribution has to be solved from the highest such ancestor
+    int parent = parents.getUnchecked (index);
+    while (parent >= 0
+           && types.getUnchecked (index) == LayoutItem::SubLayout
+           && ! isGrid (index) && ! isFlow (index)
+           && (stretchX.getUnchecked (index) <= 0 || stretchY.getUnchecked (index) <= 0)) {
+        index  = parent;
+        parent = parents.getUnchecked (index);
+    }
+    return index;
+}
+
+void LayoutPlan::markDirty (int index, DirtyState state)
+{
+    const DirtyState current = dirty.getUnchecked (index);
+    if (current == Clean) {
+        ++numDirty;
+    }
+    if (state > current) {
+        dirty.set (index, state);
+    }
+}
+
+bool LayoutPlan::hasChanges () const
+{
+    return numDirty > 0;
+}
+
+juce::Rectangle<int> LayoutPlan::getSolvedBounds () const
+{
+    return solvedBounds;
+}
+
+bool LayoutPlan::needsSolve (juce::Rectangle<int> bounds) const
+{
+    return ! solved || bounds != solvedBounds || numDirty > 0;
+}
+
+void LayoutPlan::getSolution (Solution& solution) const
+{
+    solution.bounds            = solvedBounds;
+    solution.itemBounds        = itemBounds;
+    solution.boundsAreFinal    = boundsAreFinal;
+    solution.notifyListeners   = notifyListeners;
+    solution.relativePositions = relativePositions;
+}
+
+void LayoutPlan::restoreSolution (const Solution& solution)
+{
+    jassert (solution.itemBounds.size() == nodes.size());
+    jassert (numDirty == 0);
+
+    itemBounds        = solution.itemBounds;
+    boundsAreFinal    = solution.boundsAreFinal;
+    notifyListeners   = solution.notifyListeners;
+    relativePositions = solution.relativePositions;
+    solvedBounds      = solution.bounds;
+    solved            = true;
+
+    clearSolvedItems();
+    for (int index=1; index < nodes.size(); ++index) {
+        addSolvedItem (index);
+        // the line breaks belong to the bounds solved before
+        invalidateFlow (index);
+    }
+}
+
+juce::Rectangle<int> LayoutPlan::getItemBounds (int index) const
+{
+    return itemBounds [index];
+}
+
+juce::Rectangle<int> LayoutPlan::getItemBounds (const juce::ValueTree& node) const
+{
+    return itemBounds [indexOf (node)];
+}
+
+juce::Rectangle<int> LayoutPlan::getAppliedBounds (int index) const
+{
+    // the data is only replaced on the message thread, never while solving
+    if (juce::isPositiveAndBelow (index, sharedData.size())) {
+        if (const LayoutItem::SharedLayoutData* data = sharedData.getReference (index)) {
+            return data->itemBounds;
+        }
+    }
+    return juce::Rectangle<int>();
+}
+
+juce::Rectangle<int> LayoutPlan::getComponentBounds (int index) const
+{
+    if (! juce::isPositiveAndBelow (index, nodes.size())) {
+        return juce::Rectangle<int>();
+    }
+    const LayoutItem::ItemType type = types.getUnchecked (index);
+    // component in a layout is a GroupComponent, so don't pad component but contents
+    if (type == LayoutItem::SubLayout || type == LayoutItem::SplitterItem) {
+        return itemBounds.getUnchecked (index);
+    }
+    return getPaddedItemBounds (index);
+}
+
+float LayoutPlan::getRelativePosition (int index) const
+{
+    return relativePositions [index];
+}
+
+void LayoutPlan::compile (const juce::ValueTree& root, bool attachToItems)
+{
+    clear();
+    if (! root.isValid()) {
+        return;
+    }
+
+    nodes.add (root);
+    parents.add (-1);
+
+    // breadth first, so the children of each node end up next to each other
+    for (int index=0; index < nodes.size(); ++index) {
+        const juce::ValueTree node = nodes.getReference (index);
+        const LayoutItem::ItemType type = getItemType (node.getType());
+        types.add (type);
+        sharedData.add (LayoutItem::getSharedData (node));
+        firstChildren.add (nodes.size());
+        if (type == LayoutItem::SubLayout) {
+            numChildren.add (node.getNumChildren());
+            for (int i=0; i < node.getNumChildren(); ++i) {
+                nodes.add (node.getChild (i));
+                parents.add (index);
+            }
+        }
+        else {
+            numChildren.add (0);
+        }
+    }
+
+    const int numItems = nodes.size();
+    orientations.insertMultiple (0, LayoutItem::Unknown, numItems);
+    stretchX.insertMultiple (0, 1.0f, numItems);
+    stretchY.insertMultiple (0, 1.0f, numItems);
+    minWidths.insertMultiple (0, -1, numItems);
+    maxWidths.insertMultiple (0, -1, numItems);
+    minHeights.insertMultiple (0, -1, numItems);
+    maxHeights.insertMultiple (0, -1, numItems);
+    aspectRatios.insertMultiple (0, 0.0f, numItems);
+    paddingTops.insertMultiple (0, 0, numItems);
+    paddingLefts.insertMultiple (0, 0, numItems);
+    paddingRights.insertMultiple (0, 0, numItems);
+    paddingBottoms.insertMultiple (0, 0, numItems);
+    overlays.insertMultiple (0, 0, numItems);
+    overlayWidths.insertMultiple (0, 1.0f, numItems);
+    overlayHeights.insertMultiple (0, 1.0f, numItems);
+    overlayJustifications.insertMultiple (0, 36, numItems);
+    relativePositions.insertMultiple (0, 0.5f, numItems);
+    gridColumns.insertMultiple (0, juce::Array<GridTrack>(), numItems);
+    gridRows.insertMultiple (0, juce::Array<GridTrack>(), numItems);
+    const GridCell noCell = { -1, -1, 1, 1 };
+    gridCells.insertMultiple (0, noCell, numItems);
+    FlowState noFlow;
+    noFlow.numValid = 0;
+    noFlow.bottom   = 0;
+    flowStates.insertMultiple (0, noFlow, numItems);
+    virtualLists.insertMultiple (0, false, numItems);
+    visibleStarts.insertMultiple (0, 0, numItems);
+    visibleEnds.insertMultiple (0, -1, numItems);
+    virtualOffsets.insertMultiple (0, juce::Array<int>(), numItems);
+    aggregatesValid.insertMultiple (0, false, numItems);
+    totalStretchX.insertMultiple (0, 1.0f, numItems);
+    totalStretchY.insertMultiple (0, 1.0f, numItems);
+    remainingMinWidths.insertMultiple (0, -1, numItems);
+    remainingMinHeights.insertMultiple (0, -1, numItems);
+    dirty.insertMultiple (0, Clean, numItems);
+    movedSplitters.insertMultiple (0, false, numItems);
+    itemBounds.insertMultiple (0, juce::Rectangle<int>(), numItems);
+    boundsAreFinal.insertMultiple (0, false, numItems);
+    flexSizes.insertMultiple (0, 0.0f, numItems);
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    nodeStats.insertMultiple (0, LayoutNodeStats(), numItems);
+    nodePaths.ensureStorageAllocated (numItems);
+    for (int index=0; index < numItems; ++index) {
+        const int parent = parents.getUnchecked (index);
+        if (parent < 0) {
+            nodePaths.add (LayoutTraceRecorder::getNodeName (nodes.getReference (index), -1));
+        }
+        else {
+            nodePaths.add (nodePaths [parent] + "/" + LayoutTraceRecorder::getNodeName (nodes.getReference (index), index - firstChildren.getUnchecked (parent)));
+        }
+    }
+#endif
+    notifyListeners.insertMultiple (0, false, numItems);
+    isSolvedItem.insertMultiple (0, false, numItems);
+
+    for (int index=0; index < numItems; ++index) {
+        readProperties (index);
+    }
+    for (int index=0; index < numItems; ++index) {
+        if (isGrid (index)) {
+            placeGridCells (index);
+        }
+    }
+
+    if (attachToItems) {
+        for (int index=0; index < numItems; ++index) {
+            juce::ReferenceCountedObjectPtr<LayoutItem::SharedLayoutData>& data = sharedData.getReference (index);
+            if (data == nullptr) {
+                // writing data into every node would notify all tree listeners and put objects
+                // into the user's tree, so the plan keeps it, until the item gets a listener
+                data = new LayoutItem::SharedLayoutData();
+            }
+            data->planIndex = index;
+        }
+    }
+    compiled = true;
+}
+
+void LayoutPlan::readProperties (int index)
+{
+    const juce::ValueTree& node = nodes.getReference (index);
+    const LayoutItem item (node);
+    const bool isLayout = types.getUnchecked (index) == LayoutItem::SubLayout;
+
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    ++nodeStats.getReference (index).numPropertyUpdates;
+#endif
+
+    orientations.set          (index, item.getOrientation());
+    // sub layouts cummulate the stretch of their children by default
+    stretchX.set              (index, node.getProperty (LayoutItem::propStretchX, isLayout ? -1.0 : 1.0));
+    stretchY.set              (index, node.getProperty (LayoutItem::propStretchY, isLayout ? -1.0 : 1.0));
+    minWidths.set             (index, item.getMinimumWidth());
+    maxWidths.set             (index, item.getMaximumWidth());
+    minHeights.set            (index, item.getMinimumHeight());
+    maxHeights.set            (index, item.getMaximumHeight());
+    aspectRatios.set          (index, item.getAspectRatio());
+    paddingTops.set           (index, item.getPaddingTop());
+    paddingLefts.set          (index, item.getPaddingLeft());
+    paddingRights.set         (index, item.getPaddingRight());
+    paddingBottoms.set        (index, item.getPaddingBottom());
+    overlays.set              (index, item.isOverlay());
+    overlayWidths.set         (index, item.getOverlayWidth());
+    overlayHeights.set        (index, item.getOverlayHeight());
+    overlayJustifications.set (index, item.getOverlayJustification());
+    if (types.getUnchecked (index) == LayoutItem::SplitterItem) {
+        relativePositions.set (index, node.getProperty (LayoutSplitter::propRelativePosition, 0.5));
+    }
+    virtualLists.set          (index, isLayout && static_cast<bool> (node.getProperty (LayoutItem::propVirtual, false)));
+    // stays set until the next compile, even if the property is removed again
+    containsVirtualLists |= isVirtual (index);
+}
+
+LayoutItem::ItemType LayoutPlan::getItemType (const juce::Identifier& type)
+{
+    if (type == LayoutItem::itemTypeSubLayout) {
+        return LayoutItem::SubLayout;
+    }
+    else if (type == LayoutItem::itemTypeComponent || type == LayoutItem::itemTypeBuilder) {
+        return LayoutItem::ComponentItem;
+    }
+    else if (type == LayoutItem::itemTypeLabeledComponent) {
+        return LayoutItem::LabeledComponentItem;
+    }
+    else if (type == LayoutItem::itemTypeSplitter) {
+        return LayoutItem::SplitterItem;
+    }
+    else if (type == LayoutItem::itemTypeSpacer) {
+        return LayoutItem::SpacerItem;
+    }
+    else if (type == LayoutItem::itemTypeLine) {
+        return LayoutItem::LineItem;
+    }
+    return LayoutItem::Invalid;
+}
+
+bool LayoutPlan::isHorizontal (int index) const
+{
+    const LayoutItem::Orientation o = orientations.getUnchecked (index);
+    return o == LayoutItem::LeftToRight || o == LayoutItem::RightToLeft;
+}
+
+bool LayoutPlan::isVertical (int index) const
+{
+    const LayoutItem::Orientation o = orientations.getUnchecked (index);
+    return o == LayoutItem::TopDown || o == LayoutItem::BottomUp;
+}
+
+bool LayoutPlan::isFlow (int index) const
+{
+    return types.getUnchecked (index) == LayoutItem::SubLayout && orientations.getUnchecked (index) == LayoutItem::FlowLayout;
+}
+
+bool LayoutPlan::isVirtual (int index) const
+{
+    const LayoutItem::Orientation o = orientations.getUnchecked (index);
+    return virtualLists.getUnchecked (index) && (o == LayoutItem::TopDown || o == LayoutItem::LeftToRight);
+}
+
+bool LayoutPlan::isGrid (int index) const
+{
+    return types.getUnchecked (index) == LayoutItem::SubLayout && orientations.getUnchecked (index) == LayoutItem::GridLayout;
+}
+
+void LayoutPlan::parseGridTracks (const juce::String& text, juce::Array<GridTrack>& tracks)
+{
+    tracks.clearQuick();
+    juce::StringArray tokens;
+    tokens.addTokens (text, " ,", "");
+    tokens.removeEmptyStrings();
+    for (int i=0; i < tokens.size(); ++i) {
+        juce::String spec = tokens [i];
+        int count = 1;
+        if (spec.containsChar ('*')) {
+            count = spec.upToFirstOccurrenceOf ("*", false, false).getIntValue();
+            spec  = spec.fromFirstOccurrenceOf ("*", false, false);
+        }
+        juce::StringArray values;
+        values.addTokens (spec, ":", "");
+        GridTrack track;
+        track.stretch = values.size() > 0 && values [0].isNotEmpty() ? values [0].getFloatValue() : 1.0f;
+        track.minSize = values.size() > 1 ? values [1].getIntValue() : -1;
+        track.maxSize = values.size() > 2 ? values [2].getIntValue() : -1;
+        track.start   = 0;
+        track.size    = 0;
+        track.flexSize = 0.0f;
+        track.frozen  = false;
+        for (int j=0; j < count; ++j) {
+            tracks.add (track);
+        }
+    }
+}
+
+void LayoutPlan::placeGridCells (int index)
+{
+    const juce::ValueTree& node = nodes.getReference (index);
+    juce::Array<GridTrack>& columns = gridColumns.getReference (index);
+    juce::Array<GridTrack>& rows    = gridRows.getReference (index);
+    parseGridTracks (node.getProperty (LayoutItem::propGridColumns).toString(), columns);
+    parseGridTracks (node.getProperty (LayoutItem::propGridRows).toString(), rows);
+
+    // items without a cell fill the grid row by row, without looking at the explicitly placed ones
+    const int numColumns = juce::jmax (columns.size(), 1);
+    int next = 0;
+    const int first = firstChildren.getUnchecked (index);
+    for (int child = first; child < first + numChildren.getUnchecked (index); ++child) {
+        const juce::ValueTree& childNode = nodes.getReference (child);
+        GridCell& cell  = gridCells.getReference (child);
+        cell.columnSpan = juce::jmax (1, static_cast<int> (childNode.getProperty (LayoutItem::propGridColumnSpan, 1)));
+        cell.rowSpan    = juce::jmax (1, static_cast<int> (childNode.getProperty (LayoutItem::propGridRowSpan, 1)));
+        if (childNode.hasProperty (LayoutItem::propGridColumn) || childNode.hasProperty (LayoutItem::propGridRow)) {
+            cell.column = childNode.getProperty (LayoutItem::propGridColumn, 0);
+            cell.row    = childNode.getProperty (LayoutItem::propGridRow, 0);
+        }
+        else if (overlays.getUnchecked (child) < 1) {
+            if (next % numColumns > 0 && next % numColumns + cell.columnSpan > numColumns) {
+                next += numColumns - next % numColumns;
+            }
+            cell.column = next % numColumns;
+            cell.row    = next / numColumns;
+            next += cell.columnSpan;
+        }
+    }
+}
+
+/** Lets LayoutDistribution work on the rows or columns of a grid, the slots are the track indices */
+class LayoutPlan::GridTracks
+{
+public:
+    GridTracks (juce::Array<GridTrack>& tracksToUse)
+      : tracks (tracksToUse)
+    {
+    }
+
+    bool isFlexible (int) const                 { return true; }
+    bool isFrozen (int slot) const              { return tracks.getReference (slot).frozen; }
+    void freeze (int slot)                      { tracks.getReference (slot).frozen = true; }
+    float getStretch (int slot)                 { return tracks.getReference (slot).stretch; }
+    float getSize (int slot) const              { return tracks.getReference (slot).flexSize; }
+    void setSize (int slot, float size)         { tracks.getReference (slot).flexSize = size; }
+
+    float clampToSizeLimits (int slot, float size) const
+    {
+        const GridTrack& track = tracks.getReference (slot);
+        return LayoutDistribution::clampToSizeLimits (size, track.minSize, track.maxSize);
+    }
+
+private:
+    juce::Array<GridTrack>& tracks;
+
+    JUCE_DECLARE_NON_COPYABLE (GridTracks)
+};
+
+void LayoutPlan::distributeGridTracks (juce::Array<GridTrack>& tracks, int start, int length)
+{
+    // tracks hitting their limits are frozen until the others fit, like the children of a sub layout
+    for (int i=0; i < tracks.size(); ++i) {
+        tracks.getReference (i).frozen = false;
+    }
+    GridTracks flexibleTracks (tracks);
+    LayoutDistribution::resolveFlexibleSizes (flexibleTracks, length, 0, tracks.size());
+
+    // rounding the edges avoids gaps between the cells
+    float position = start;
+    for (int i=0; i < tracks.size(); ++i) {
+        GridTrack& track = tracks.getReference (i);
+        track.start = juce::roundToInt (position);
+        position   += track.flexSize;
+        track.size  = juce::roundToInt (position) - track.start;
+    }
+}
+
+juce::Rectangle<int> LayoutPlan::getPaddedItemBounds (int index) const
+{
+    const int paddingLeft = paddingLefts.getUnchecked (index);
+    const int paddingTop  = paddingTops.getUnchecked (index);
+    const juce::Rectangle<int>& bounds = itemBounds.getReference (index);
+    return juce::Rectangle<int> (bounds.getX() + paddingLeft,
+                                 bounds.getY() + paddingTop,
+                                 bounds.getWidth()  - (paddingLeft + paddingRights.getUnchecked (index)),
+                                 bounds.getHeight() - (paddingTop  + paddingBottoms.getUnchecked (index)));
+}
+
+void LayoutPlan::constrainBounds (int index, juce::Rectangle<int>& bounds, bool& changedWidth, bool& changedHeight, bool preferVertical) const
+{
+    LayoutItem::constrainBounds (bounds, changedWidth, changedHeight, preferVertical,
+                                 minWidths.getUnchecked (index),
+                                 maxWidths.getUnchecked (index),
+                                 minHeights.getUnchecked (index),
+                                 maxHeights.getUnchecked (index),
+                                 aspectRatios.getUnchecked (index));
+}
+
+void LayoutPlan::getTotalStretch (int index, float& w, float& h)
+{
+    if (types.getUnchecked (index) == LayoutItem::SubLayout) {
+        updateAggregates (index);
+        w = totalStretchX.getUnchecked (index);
+        h = totalStretchY.getUnchecked (index);
+    }
+    else {
+        w = stretchX.getUnchecked (index);
+        h = stretchY.getUnchecked (index);
+    }
+}
+
+void LayoutPlan::getStretch (int index, float& w, float& h, int start, int end)
+{
+    const float sx = stretchX.getUnchecked (index);
+    const float sy = stretchY.getUnchecked (index);
+    if (types.getUnchecked (index) != LayoutItem::SubLayout) {
+        w = sx;
+        h = sy;
+        return;
+    }
+
+    const bool horizontal = isHorizontal (index);
+    const bool vertical   = isVertical (index);
+
+    w = std::max (sx, 0.0f);
+    h = std::max (sy, 0.0f);
+
+    if (w > 0.0001 && h > 0.0001) {
+        return;
+    }
+
+    if (orientations.getUnchecked (index) == LayoutItem::FlowLayout) {
+        // the items of a flow keep their size, so there is nothing to cummulate
+        if (w <= 0.0) w = 1.0;
+        if (h <= 0.0) h = 1.0;
+        return;
+    }
+
+    if (orientations.getUnchecked (index) == LayoutItem::GridLayout) {
+        // a grid stretches like its tracks
+        const juce::Array<GridTrack>& columns = gridColumns.getReference (index);
+        const juce::Array<GridTrack>& rows    = gridRows.getReference (index);
+        for (int i=0; i < columns.size() && sx <= 0; ++i) w += columns.getReference (i).stretch;
+        for (int i=0; i < rows.size()    && sy <= 0; ++i) h += rows.getReference (i).stretch;
+        if (w <= 0.0) w = 1.0;
+        if (h <= 0.0) h = 1.0;
+        return;
+    }
+
+    const int first = firstChildren.getUnchecked (index);
+    for (int child = first + start; child < first + std::min (end, numChildren.getUnchecked (index)); ++child) {
+        if (overlays.getUnchecked (child) < 1) {
+            float x, y;
+            getTotalStretch (child, x, y);
+            if (horizontal) {
+                if (sx <= 0) w += x;
+                if (sy <= 0) h = std::max (h, y);
+            }
+            else if (vertical) {
+                if (sx <= 0) w = std::max (w, x);
+                if (sy <= 0) h += y;
+            }
+            else {
+                if (sx <= 0) w += x;
+                if (sy <= 0) h += y;
+            }
+        }
+    }
+
+    // no stretch in children defaults to 1.0
+    if (w <= 0.0) w = 1.0;
+    if (h <= 0.0) h = 1.0;
+}
+
+void LayoutPlan::getSizeLimits (int index, int& minW, int& maxW, int& minH, int& maxH, int start, int end) const
+{
+    bool canConsumeWidth  = false;
+    bool canConsumeHeight = false;
+
+    const int first = firstChildren.getUnchecked (index);
+    const int num   = std::min (end, numChildren.getUnchecked (index));
+
+    if (isVertical (index)) {
+        for (int child = first + start; child < first + num; ++child) {
+            if (overlays.getUnchecked (child) < 1) {
+                const int cMinW = minWidths.getUnchecked (child);
+                const int cMaxW = maxWidths.getUnchecked (child);
+                const int cMinH = minHeights.getUnchecked (child);
+                const int cMaxH = maxHeights.getUnchecked (child);
+                if (cMinW >= 0) minW = (minW < 0) ? cMinW : juce::jmax (minW, cMinW);
+                if (cMaxW >= 0) maxW = (maxW < 0) ? cMaxW : juce::jmin (maxW, cMaxW);
+                if (cMinH >= 0) minH = (minH < 0) ? cMinH : minH + cMinH;
+                if (cMaxH >= 0) {
+                    maxH = (maxH < 0) ? cMaxH : maxH + cMaxH;
+                }
+                else {
+                    canConsumeHeight = true;
+                }
+            }
+        }
+    }
+    else if (isHorizontal (index)) {
+        for (int child = first + start; child < first + num; ++child) {
+            if (overlays.getUnchecked (child) < 1) {
+                const int cMinW = minWidths.getUnchecked (child);
+                const int cMaxW = maxWidths.getUnchecked (child);
+                const int cMinH = minHeights.getUnchecked (child);
+                const int cMaxH = maxHeights.getUnchecked (child);
+                if (cMinW >= 0) minW = (minW < 0) ? cMinW : minW + cMinW;
+                if (cMaxW >= 0) {
+                    maxW = (maxW < 0) ? cMaxW : maxW + cMaxW;
+                }
+                else {
+                    canConsumeWidth = true;
+                }
+                if (cMinH >= 0) minH = (minH < 0) ? cMinH : juce::jmax (minH, cMinH);
+                if (cMaxH >= 0) maxH = (maxH < 0) ? cMaxH : juce::jmin (maxH, cMaxH);
+            }
+        }
+    }
+    if (canConsumeWidth)  maxW = -1;
+    if (canConsumeHeight) maxH = -1;
+}
+
+void LayoutPlan::updateAggregates (int index)
+{
+    if (aggregatesValid.getUnchecked (index)) {
+        return;
+    }
+
+    const int first = firstChildren.getUnchecked (index);
+    const int num   = numChildren.getUnchecked (index);
+
+    float w, h;
+    getStretch (index, w, h, 0, num);
+    totalStretchX.set (index, w);
+    totalStretchY.set (index, h);
+
+    // walk backwards, so each child gets the limits of itself and all siblings after it
+    const bool vertical   = isVertical (index);
+    const bool horizontal = isHorizontal (index);
+    // only the minimum sizes are needed, they clamp the splitters
+    int minW = -1;
+    int minH = -1;
+    for (int child = first + num - 1; child >= first; --child) {
+        if (overlays.getUnchecked (child) < 1 && (vertical || horizontal)) {
+            const int cMinW = minWidths.getUnchecked (child);
+            const int cMinH = minHeights.getUnchecked (child);
+            if (vertical) {
+                if (cMinW >= 0) minW = (minW < 0) ? cMinW : juce::jmax (minW, cMinW);
+                if (cMinH >= 0) minH = (minH < 0) ? cMinH : minH + cMinH;
+            }
+            else {
+                if (cMinW >= 0) minW = (minW < 0) ? cMinW : minW + cMinW;
+                if (cMinH >= 0) minH = (minH < 0) ? cMinH : juce::jmax (minH, cMinH);
+            }
+        }
+        remainingMinWidths.set  (child, minW);
+        remainingMinHeights.set (child, minH);
+    }
+
+    if (isVirtual (index)) {
+        juce::Array<int>& offsets = virtualOffsets.getReference (index);
+        offsets.resize (num + 1);
+        int offset = 0;
+        for (int i=0; i < num; ++i) {
+            offsets.set (i, offset);
+            if (overlays.getUnchecked (first + i) < 1) {
+                offset += getVirtualItemSize (first + i, vertical);
+            }
+        }
+        offsets.set (num, offset);
+    }
+    aggregatesValid.set (index, true);
+}
+
+void LayoutPlan::invalidateAggregates (int index)
+{
+    // the stretch of a sub layout includes its children, so all ancestors are affected
+    while (index >= 0) {
+        aggregatesValid.set (index, false);
+        index = parents.getUnchecked (index);
+    }
+}
+
+void LayoutPlan::clampSplitterPosition (int index, float minPosition, float maxPosition)
+{
+    relativePositions.set (index, LayoutDistribution::clampSplitterPosition (relativePositions.getUnchecked (index), minPosition, maxPosition));
+}
+
+//==============================================================================
+
+void LayoutPlan::solve (juce::Rectangle<int> bounds)
+{
+    // all items are computed again, so earlier results are replaced
+    clearSolvedItems();
+    if (compiled && nodes.size() > 0) {
+        solveNode (0, bounds);
+        solved       = true;
+        solvedBounds = bounds;
+    }
+}
+
+bool LayoutPlan::solveChanges (juce::Rectangle<int> bounds)
+{
+    if (! solved || bounds != solvedBounds) {
+        solve (bounds);
+        return ! solvedItems.isEmpty();
+    }
+
+    // parents have lower indices, so a dirty sub layout inside an other one was
+    // already solved and cleaned, when the loop arrives there
+    for (int index=0; index < nodes.size() && numDirty > 0; ++index) {
+        const DirtyState state = dirty.getUnchecked (index);
+        if (state != Clean) {
+            solveNode (index, index == 0 ? solvedBounds : getPaddedItemBounds (index), state == SplittersMoved);
+        }
+    }
+    return ! solvedItems.isEmpty();
+}
+
+void LayoutPlan::solveNode (int index, juce::Rectangle<int> bounds, bool onlyMovedSplitters)
+{
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    const ScopedSolveTimer solveTimer (*this, index);
+#endif
+
+    if (dirty.getUnchecked (index) != Clean) {
+        dirty.set (index, Clean);
+        --numDirty;
+    }
+
+    if (types.getUnchecked (index) != LayoutItem::SubLayout) {
+        return;
+    }
+
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    const LayoutTraceRecorder::ScopedSpan solveSpan (traceRecorder, nodePaths [index], "solve");
+#endif
+
+    updateAggregates (index);
+
+    if (isGrid (index)) {
+        solveGrid (index, bounds);
+        return;
+    }
+    if (isFlow (index)) {
+        solveFlow (index, bounds);
+        return;
+    }
+    if (isVirtual (index)) {
+        solveVirtual (index, bounds);
+        return;
+    }
+
+    const LayoutItem::Orientation orientation = orientations.getUnchecked (index);
+    const int first = firstChildren.getUnchecked (index);
+    const int num   = numChildren.getUnchecked (index);
+
+    // find splitter items
+    int last = 0;
+    bool previousMoved = false;
+    juce::Rectangle<int> childBounds (bounds);
+    for (int i=0; i<num; ++i) {
+        const int child = first + i;
+        if (overlays.getUnchecked (child) < 1 && types.getUnchecked (child) == LayoutItem::SplitterItem) {
+            juce::Rectangle<int> splitterBounds (bounds);
+
+            // when a splitter is dragged, only the segments next to it change and
+            // the positions of the other splitters are already clamped
+            const bool moved = movedSplitters.getUnchecked (child);
+            movedSplitters.set (child, false);
+            const bool clamp        = ! onlyMovedSplitters || moved;
+            const bool solveSegment = ! onlyMovedSplitters || moved || previousMoved;
+            previousMoved = moved;
+
+            // calculate minimum and maximum splitter positions
+            int leftMinW = -1;
+            int leftMaxW = -1;
+            int leftMinH = -1;
+            int leftMaxH = -1;
+            if (clamp) {
+                getSizeLimits (index, leftMinW, leftMaxW, leftMinH, leftMaxH, last, i);
+            }
+            const int rightMinW = remainingMinWidths.getUnchecked (child);
+            const int rightMinH = remainingMinHeights.getUnchecked (child);
+            float minPosition, maxPosition;
+            if (clamp && LayoutDistribution::getSplitterLimits (orientation, bounds, leftMinW, leftMinH, rightMinW, rightMinH, minPosition, maxPosition)) {
+                clampSplitterPosition (child, minPosition, maxPosition);
+            }
+
+            if (orientation == LayoutItem::LeftToRight) {
+                int right = childBounds.getX() + relativePositions.getUnchecked (child) * bounds.getWidth();
+                if (solveSegment) {
+                    solve (index, childBounds.withRight (right-1), last, i);
+                }
+                splitterBounds.setX (right-1);
+                splitterBounds.setWidth (3);
+                childBounds.setLeft (right+1);
+            }
+            else if (orientation == LayoutItem::TopDown) {
+                int bottom = childBounds.getY() + relativePositions.getUnchecked (child) * bounds.getHeight();
+                if (solveSegment) {
+                    solve (index, childBounds.withBottom (bottom), last, i);
+                }
+                splitterBounds.setY (bottom-1);
+                splitterBounds.setHeight (3);
+                childBounds.setTop (bottom+1);
+            }
+            else if (orientation == LayoutItem::RightToLeft) {
+                int left = childBounds.getX() + relativePositions.getUnchecked (child) * bounds.getWidth();
+                if (solveSegment) {
+                    solve (index, childBounds.withLeft (left), last, i);
+                }
+                splitterBounds.setX (left-1);
+                splitterBounds.setWidth (3);
+                childBounds.setRight (left-1);
+            }
+            else if (orientation == LayoutItem::BottomUp) {
+                int top = childBounds.getY() + relativePositions.getUnchecked (child) * bounds.getHeight();
+                if (solveSegment) {
+                    solve (index, childBounds.withTop (top), last, i);
+                }
+                splitterBounds.setY (top-1);
+                splitterBounds.setHeight (3);
+                childBounds.setBottom (top-1);
+            }
+            itemBounds.set (child, splitterBounds);
+            boundsAreFinal.set (child, true);
+            notifyListeners.set (child, false);
+            if (clamp) {
+                addSolvedItem (child);
+            }
+
+            i++;
+            last = i;
+        }
+    }
+
+    // layout rest right of splitter, if any
+    if (! onlyMovedSplitters || previousMoved) {
+        solve (index, childBounds, last, num);
+    }
+}
+
+void LayoutPlan::solveChild (int index)
+{
+    addSolvedItem (index);
+    if (types.getUnchecked (index) == LayoutItem::SubLayout) {
+        solveNode (index, getPaddedItemBounds (index));
+    }
+}
+
+void LayoutPlan::addSolvedItem (int index)
+{
+    if (! isSolvedItem.getUnchecked (index)) {
+        isSolvedItem.set (index, true);
+        solvedItems.add (index);
+    }
+}
+
+void LayoutPlan::clearSolvedItems ()
+{
+    for (int i=0; i < solvedItems.size(); ++i) {
+        isSolvedItem.set (solvedItems.getUnchecked (i), false);
+    }
+    solvedItems.clearQuick();
+}
+
+void LayoutPlan::solveGrid (int index, juce::Rectangle<int> bounds)
+{
+    juce::Array<GridTrack>& columns = gridColumns.getReference (index);
+    juce::Array<GridTrack>& rows    = gridRows.getReference (index);
+    distributeGridTracks (columns, bounds.getX(), bounds.getWidth());
+    distributeGridTracks (rows,    bounds.getY(), bounds.getHeight());
+
+    const int first = firstChildren.getUnchecked (index);
+    for (int child = first; child < first + numChildren.getUnchecked (index); ++child) {
+        const int overlay = overlays.getUnchecked (child);
+        juce::Rectangle<int> cellBounds;
+        if (overlay < 1) {
+            // cells outside the grid get empty bounds
+            const GridCell& cell = gridCells.getReference (child);
+            if (juce::isPositiveAndBelow (cell.column, columns.size()) && juce::isPositiveAndBelow (cell.row, rows.size())) {
+                const GridTrack& left   = columns.getReference (cell.column);
+                const GridTrack& right  = columns.getReference (juce::jmin (cell.column + cell.columnSpan, columns.size()) - 1);
+                const GridTrack& top    = rows.getReference (cell.row);
+                const GridTrack& bottom = rows.getReference (juce::jmin (cell.row + cell.rowSpan, rows.size()) - 1);
+                cellBounds.setBounds (left.start, top.start, right.start + right.size - left.start, bottom.start + bottom.size - top.start);
+            }
+        }
+        else if (overlay == 1 && child > first) {
+            cellBounds = itemBounds.getReference (child - 1);
+        }
+        else if (overlay == 2) {
+            cellBounds = bounds;
+        }
+
+        juce::Rectangle<int> childBounds (0, 0, cellBounds.getWidth(), cellBounds.getHeight());
+        if (overlay >= 1) {
+            childBounds.setSize (overlayWidths.getUnchecked (child)  * cellBounds.getWidth(),
+                                 overlayHeights.getUnchecked (child) * cellBounds.getHeight());
+        }
+        bool changedWidth, changedHeight;
+        constrainBounds (child, childBounds, changedWidth, changedHeight, true);
+        // items, that don't fill their cell, are placed by their overlayJustification
+        juce::Justification j (overlayJustifications.getUnchecked (child));
+        itemBounds.set (child, j.appliedToRectangle (childBounds, cellBounds));
+        boundsAreFinal.set (child, changedWidth || changedHeight);
+        notifyListeners.set (child, true);
+        solveChild (child);
+    }
+}
+
+void LayoutPlan::invalidateFlow (int index, int offset)
+{
+    if (isFlow (index)) {
+        FlowState& flow = flowStates.getReference (index);
+        flow.numValid = juce::jmin (flow.numValid, offset);
+    }
+}
+
+void LayoutPlan::getFlowItemSize (int index, int availableWidth, int& w, int& h) const
+{
+    const int minW = minWidths.getUnchecked (index);
+    const int maxW = maxWidths.getUnchecked (index);
+    const int minH = minHeights.getUnchecked (index);
+    const int maxH = maxHeights.getUnchecked (index);
+    const float aspectRatio = aspectRatios.getUnchecked (index);
+
+    w = minW > 0 ? minW : (maxW > 0 ? maxW : availableWidth);
+    w = juce::jmin (w, availableWidth);
+    h = minH > 0 ? minH : (maxH > 0 ? maxH : 0);
+    if (h == 0 && aspectRatio > 0.001) {
+        h = w / aspectRatio;
+    }
+}
+
+int LayoutPlan::solveFlow (int index, juce::Rectangle<int> bounds)
+{
+    FlowState& flow = flowStates.getReference (index);
+    const int first = firstChildren.getUnchecked (index);
+    const int num   = numChildren.getUnchecked (index);
+
+    // the line breaks depend only on the origin and the width
+    if (flow.bounds.getPosition() != bounds.getPosition() || flow.bounds.getWidth() != bounds.getWidth()) {
+        flow.numValid = 0;
+    }
+    flow.bounds = bounds;
+    if (flow.numValid >= num && flow.lineOfChild.size() == num) {
+        return juce::jmax (flow.bottom - bounds.getBottom(), 0);
+    }
+
+    // start again at the line holding the first changed child, the lines before stay
+    int line = 0;
+    if (flow.numValid > 0 && flow.numValid < flow.lineOfChild.size()) {
+        line = juce::jmin (flow.lineOfChild.getUnchecked (flow.numValid), flow.lines.size());
+    }
+    const int start = line < flow.lines.size() ? flow.lines.getReference (line).first : 0;
+    int y = line > 0 ? flow.lines.getReference (line - 1).y + flow.lines.getReference (line - 1).height : bounds.getY();
+    flow.lines.removeRange (line, flow.lines.size() - line);
+    flow.lineOfChild.resize (num);
+
+    int i = juce::jmin (start, num);
+    while (i < num) {
+        // find the end of the line and its height
+        int x = bounds.getX();
+        int lineHeight = 0;
+        int end = i;
+        for (; end < num; ++end) {
+            const int child = first + end;
+            if (overlays.getUnchecked (child) >= 1) {
+                continue;
+            }
+            int w, h;
+            getFlowItemSize (child, bounds.getWidth(), w, h);
+            if (x > bounds.getX() && x + w > bounds.getRight()) {
+                break;
+            }
+            x += w;
+            lineHeight = juce::jmax (lineHeight, h);
+        }
+
+        const FlowLine newLine = { i, y, lineHeight };
+        flow.lines.add (newLine);
+
+        x = bounds.getX();
+        for (int j=i; j < end; ++j) {
+            const int child = first + j;
+            flow.lineOfChild.set (j, flow.lines.size() - 1);
+            const int overlay = overlays.getUnchecked (child);
+            if (overlay < 1) {
+                int w, h;
+                getFlowItemSize (child, bounds.getWidth(), w, h);
+                itemBounds.set (child, juce::Rectangle<int> (x, y, w, h > 0 ? h : lineHeight));
+                x += w;
+            }
+            else {
+                // overlay other item
+                juce::Rectangle<int> overlayTarget;
+                if (overlay == 1 && j > 0) {
+                    overlayTarget = itemBounds.getReference (child - 1);
+                }
+                else if (overlay == 2) {
+                    overlayTarget = bounds;
+                }
+                juce::Rectangle<int> overlayBounds (0, 0,
+                                                    overlayWidths.getUnchecked (child)  * overlayTarget.getWidth(),
+                                                    overlayHeights.getUnchecked (child) * overlayTarget.getHeight());
+                bool changedWidth, changedHeight;
+                constrainBounds (child, overlayBounds, changedWidth, changedHeight, true);
+                juce::Justification justification (overlayJustifications.getUnchecked (child));
+                itemBounds.set (child, justification.appliedToRectangle (overlayBounds, overlayTarget));
+            }
+            boundsAreFinal.set (child, true);
+            notifyListeners.set (child, true);
+            solveChild (child);
+        }
+        y += lineHeight;
+        i = end;
+    }
+
+    flow.numValid = num;
+    flow.bottom   = y;
+    return juce::jmax (y - bounds.getBottom(), 0);
+}
+
+void LayoutPlan::setVisibleArea (juce::Rectangle<int> area)
+{
+    visibleArea = area;
+    if (! compiled || ! solved) {
+        return;
+    }
+    for (int index=0; index < nodes.size(); ++index) {
+        if (isVirtual (index)) {
+            int start, end;
+            updateAggregates (index);
+            getVisibleChildren (index, index == 0 ? solvedBounds : getPaddedItemBounds (index), start, end);
+            if (start != visibleStarts.getUnchecked (index) || end != visibleEnds.getUnchecked (index)) {
+                markDirty (index, Changed);
+            }
+        }
+    }
+}
+
+juce::Rectangle<int> LayoutPlan::getVisibleArea () const
+{
+    return visibleArea;
+}
+
+bool LayoutPlan::hasVirtualItems () const
+{
+    return containsVirtualLists;
+}
+
+int LayoutPlan::getVirtualContentSize (int index)
+{
+    if (! juce::isPositiveAndBelow (index, nodes.size()) || ! isVirtual (index)) {
+        return 0;
+    }
+    updateAggregates (index);
+    return virtualOffsets.getReference (index).getLast();
+}
+
+int LayoutPlan::getVirtualItemSize (int index, bool vertical) const
+{
+    const int minSize = vertical ? minHeights.getUnchecked (index) : minWidths.getUnchecked (index);
+    const int maxSize = vertical ? maxHeights.getUnchecked (index) : maxWidths.getUnchecked (index);
+    return minSize > 0 ? minSize : (maxSize > 0 ? maxSize : 20);
+}
+
+void LayoutPlan::getVisibleChildren (int index, juce::Rectangle<int> bounds, int& start, int& end) const
+{
+    const juce::Array<int>& offsets = virtualOffsets.getReference (index);
+    const int num = numChildren.getUnchecked (index);
+    start = 0;
+    end   = num;
+    if (visibleArea.isEmpty() || offsets.size() != num + 1) {
+        return;
+    }
+    if (! visibleArea.intersects (bounds)) {
+        end = 0;
+        return;
+    }
+    const bool vertical = isVertical (index);
+    const int low  = vertical ? visibleArea.getY()      - bounds.getY() : visibleArea.getX()     - bounds.getX();
+    const int high = vertical ? visibleArea.getBottom() - bounds.getY() : visibleArea.getRight() - bounds.getX();
+    // the offsets are sorted, so the visible range is found by bisection
+    start = juce::jmax (0, static_cast<int> (std::upper_bound (offsets.begin(), offsets.begin() + num, low) - offsets.begin()) - 1);
+    end   = juce::jmin (num, static_cast<int> (std::lower_bound (offsets.begin(), offsets.begin() + num, high) - offsets.begin()));
+    // overlays belong to the item before them
+    while (start > 0 && overlays.getUnchecked (firstChildren.getUnchecked (index) + start) >= 1) {
+        --start;
+    }
+}
+
+int LayoutPlan::solveVirtual (int index, juce::Rectangle<int> bounds)
+{
+    updateAggregates (index);
+    const juce::Array<int>& offsets = virtualOffsets.getReference (index);
+    const bool vertical = isVertical (index);
+    const int first = firstChildren.getUnchecked (index);
+
+    int start, end;
+    getVisibleChildren (index, bounds, start, end);
+    visibleStarts.set (index, start);
+    visibleEnds.set (index, end);
+
+    for (int i=start; i < end; ++i) {
+        const int child = first + i;
+        const int overlay = overlays.getUnchecked (child);
+        // an overlay has no size of its own, so its offset is the end of the item before
+        const int slot = overlay == 1 ? juce::jmax (i - 1, 0) : i;
+        juce::Rectangle<int> slotBounds;
+        if (vertical) {
+            slotBounds.setBounds (bounds.getX(), bounds.getY() + offsets.getUnchecked (slot), bounds.getWidth(), offsets.getUnchecked (slot + 1) - offsets.getUnchecked (slot));
+        }
+        else {
+            slotBounds.setBounds (bounds.getX() + offsets.getUnchecked (slot), bounds.getY(), offsets.getUnchecked (slot + 1) - offsets.getUnchecked (slot), bounds.getHeight());
+        }
+        if (overlay < 1) {
+            itemBounds.set (child, slotBounds);
+        }
+        else {
+            const juce::Rectangle<int> overlayTarget = overlay == 2 ? bounds : (i > 0 ? slotBounds : juce::Rectangle<int>());
+            juce::Rectangle<int> overlayBounds (0, 0,
+                                                overlayWidths.getUnchecked (child)  * overlayTarget.getWidth(),
+                                                overlayHeights.getUnchecked (child) * overlayTarget.getHeight());
+            bool changedWidth, changedHeight;
+            constrainBounds (child, overlayBounds, changedWidth, changedHeight, true);
+            juce::Justification justification (overlayJustifications.getUnchecked (child));
+            itemBounds.set (child, justification.appliedToRectangle (overlayBounds, overlayTarget));
+        }
+        boundsAreFinal.set (child, true);
+        notifyListeners.set (child, true);
+        solveChild (child);
+    }
+    return juce::jmax (offsets.getLast() - (vertical ? bounds.getHeight() : bounds.getWidth()), 0);
+}
+
+/** Lets LayoutDistribution work on the children of a sub layout, the slots are the plan indices */
+class LayoutPlan::FlexibleChildren
+{
+public:
+    FlexibleChildren (LayoutPlan& planToUse, bool verticalToUse)
+      : plan (planToUse),
+        vertical (verticalToUse)
+    {
+    }
+
+    bool isFlexible (int slot) const            { return plan.overlays.getUnchecked (slot) < 1; }
+    bool isFrozen (int slot) const              { return plan.boundsAreFinal.getUnchecked (slot); }
+    void freeze (int slot)                      { plan.boundsAreFinal.set (slot, true); }
+    float getSize (int slot) const              { return plan.flexSizes.getUnchecked (slot); }
+    void setSize (int slot, float size)         { plan.flexSizes.set (slot, size); }
+
+    float getStretch (int slot)
+    {
+        float sx, sy;
+        plan.getTotalStretch (slot, sx, sy);
+        return vertical ? sy : sx;
+    }
+
+    float clampToSizeLimits (int slot, float size) const
+    {
+        return vertical ? LayoutDistribution::clampToSizeLimits (size, plan.minHeights.getUnchecked (slot), plan.maxHeights.getUnchecked (slot))
+                        : LayoutDistribution::clampToSizeLimits (size, plan.minWidths.getUnchecked (slot),  plan.maxWidths.getUnchecked (slot));
+    }
+
+private:
+    LayoutPlan& plan;
+    const bool  vertical;
+
+    JUCE_DECLARE_NON_COPYABLE (FlexibleChildren)
+};
+
+int LayoutPlan::resolveFlexibleSizes (int index, float space, int start, int end, bool vertical)
+{
+    const int first = firstChildren.getUnchecked (index);
+    const int stop  = first + juce::jmin (numChildren.getUnchecked (index), end);
+    FlexibleChildren children (*this, vertical);
+    return LayoutDistribution::resolveFlexibleSizes (children, space, first + start, stop);
+}
+
+void LayoutPlan::distributeIntegerSizes (int index, int start, int end)
+{
+    const int first = firstChildren.getUnchecked (index);
+    const int stop  = first + juce::jmin (numChildren.getUnchecked (index), end);
+    remainderOrder.resize (juce::jmax (stop - first - start, 0));
+    // only the sizes are rounded, so the direction doesn't matter
+    FlexibleChildren children (*this, false);
+    LayoutDistribution::distributeIntegerSizes (children, first + start, stop, remainderOrder.getRawDataPointer());
+}
+
+int LayoutPlan::solve (int index, juce::Rectangle<int> bounds, int start, int end)
+{
+    if (isGrid (index)) {
+        solveGrid (index, bounds);
+        return 0;
+    }
+    if (isFlow (index)) {
+        return solveFlow (index, bounds);
+    }
+    if (isVirtual (index)) {
+        return solveVirtual (index, bounds);
+    }
+
+    int needsGrowing = 0;
+
+    float cummulatedX, cummulatedY;
+    if (start == 0 && end >= numChildren.getUnchecked (index)) {
+        updateAggregates (index);
+        cummulatedX = totalStretchX.getUnchecked (index);
+        cummulatedY = totalStretchY.getUnchecked (index);
+    }
+    else {
+        getStretch (index, cummulatedX, cummulatedY, start, end);
+    }
+    float availableWidth  = bounds.getWidth();
+    float availableHeight = bounds.getHeight();
+    const LayoutItem::Orientation orientation = orientations.getUnchecked (index);
+    const int first = firstChildren.getUnchecked (index);
+    const int stop  = first + juce::jmin (numChildren.getUnchecked (index), end);
+
+    if (isVertical (index)) {
+        for (int child = first + start; child < stop; ++child) {
+            if (overlays.getUnchecked (child) < 1) {
+                float sx, sy;
+                getTotalStretch (child, sx, sy);
+
+                float h = bounds.getHeight() * sy / cummulatedY;
+                juce::Rectangle<int> childBounds (bounds.getX(), bounds.getY(), bounds.getWidth(), h);
+                bool changedWidth, changedHeight;
+                constrainBounds (child, childBounds, changedWidth, changedHeight, true);
+                itemBounds.set (child, childBounds);
+                // the aspect ratio fixes the height, the size limits are resolved together below
+                const bool fixed = changedHeight && aspectRatios.getUnchecked (child) > 0.001;
+                boundsAreFinal.set (child, fixed);
+                flexSizes.set (child, childBounds.getHeight());
+                if (changedWidth) {
+                    availableWidth = std::max (bounds.getWidth(), childBounds.getWidth());
+                }
+            }
+        }
+        needsGrowing = resolveFlexibleSizes (index, bounds.getHeight(), start, end, true);
+        if (integerDistribution) {
+            distributeIntegerSizes (index, start, end);
+        }
+
+        float y = bounds.getY();
+        if (orientation == LayoutItem::BottomUp) {
+            y = bounds.getY() + bounds.getHeight();
+        }
+        for (int child = first + start; child < stop; ++child) {
+            const int overlay = overlays.getUnchecked (child);
+            if (overlay == 0) {
+                const float h = flexSizes.getUnchecked (child);
+                if (orientation == LayoutItem::BottomUp) {
+                    y -= h;
+                }
+                itemBounds.set (child, juce::Rectangle<int> (bounds.getX(), y, availableWidth, h));
+                notifyListeners.set (child, ! boundsAreFinal.getUnchecked (child));
+                solveChild (child);
+                if (orientation == LayoutItem::TopDown) {
+                    y += h;
+                }
+            }
+            else {
+                // overlay other item
+                juce::Rectangle<int> overlayTarget;
+                if (overlay == 1 && child > first + start) {
+                    overlayTarget = itemBounds.getReference (child - 1);
+                }
+                else if (overlay == 2) {
+                    overlayTarget = bounds;
+                }
+                juce::Rectangle<int> overlayBounds (0, 0,
+                                                    overlayWidths.getUnchecked (child) * overlayTarget.getWidth(),
+                                                    overlayHeights.getUnchecked (child) * overlayTarget.getHeight());
+                bool changedWidth, changedHeight;
+                constrainBounds (child, overlayBounds, changedWidth, changedHeight, true);
+                juce::Justification j (overlayJustifications.getUnchecked (child));
+                itemBounds.set (child, j.appliedToRectangle (overlayBounds, overlayTarget));
+                notifyListeners.set (child, true);
+                solveChild (child);
+            }
+        }
+    }
+    else if (isHorizontal (index)) {
+        for (int child = first + start; child < stop; ++child) {
+            if (overlays.getUnchecked (child) < 1) {
+                float sx, sy;
+                getTotalStretch (child, sx, sy);
+
+                float w = bounds.getWidth() * sx / cummulatedX;
+                juce::Rectangle<int> childBounds (bounds.getX(), bounds.getY(), w, bounds.getHeight());
+                bool changedWidth, changedHeight;
+                constrainBounds (child, childBounds, changedWidth, changedHeight, false);
+                itemBounds.set (child, childBounds);
+                // the aspect ratio fixes the width, the size limits are resolved together below
+                const bool fixed = changedWidth && aspectRatios.getUnchecked (child) > 0.001;
+                boundsAreFinal.set (child, fixed);
+                flexSizes.set (child, childBounds.getWidth());
+                if (changedHeight) {
+                    availableHeight = std::max (bounds.getHeight(), childBounds.getHeight());
+                }
+            }
+        }
+        needsGrowing = resolveFlexibleSizes (index, bounds.getWidth(), start, end, false);
+        if (integerDistribution) {
+            distributeIntegerSizes (index, start, end);
+        }
+
+        float x = bounds.getX();
+        if (orientation == LayoutItem::RightToLeft) {
+            x = bounds.getX() + bounds.getWidth();
+        }
+        for (int child = first + start; child < stop; ++child) {
+            const int overlay = overlays.getUnchecked (child);
+            if (overlay < 1) {
+                const float w = flexSizes.getUnchecked (child);
+                if (orientation == LayoutItem::RightToLeft) {
+                    x -= w;
+                }
+                itemBounds.set (child, juce::Rectangle<int> (x, bounds.getY(), w, availableHeight));
+                notifyListeners.set (child, ! boundsAreFinal.getUnchecked (child));
+                solveChild (child);
+                if (orientation == LayoutItem::LeftToRight) {
+                    x += w;
+                }
+            }
+            else {
+                // overlay other item
+                juce::Rectangle<int> overlayTarget;
+                if (overlay == 1 && child > first + start) {
+                    overlayTarget = itemBounds.getReference (child - 1);
+                }
+                else if (overlay == 2) {
+                    overlayTarget = bounds;
+                }
+                juce::Rectangle<int> overlayBounds (0, 0,
+                                                    overlayWidths.getUnchecked (child) * overlayTarget.getWidth(),
+                                                    overlayHeights.getUnchecked (child) * overlayTarget.getHeight());
+                bool changedWidth, changedHeight;
+                constrainBounds (child, overlayBounds, changedWidth, changedHeight, true);
+                juce::Justification j (overlayJustifications.getUnchecked (child));
+                itemBounds.set (child, j.appliedToRectangle (overlayBounds, overlayTarget));
+                notifyListeners.set (child, true);
+                solveChild (child);
+            }
+        }
+    }
+
+    return needsGrowing;
+}
+
+//==============================================================================
+
+LayoutNodeStats LayoutPlan::getNodeStats (int index) const
+{
+    LayoutNodeStats stats;
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    if (juce::isPositiveAndBelow (index, nodeStats.size())) {
+        stats = nodeStats.getUnchecked (index);
+    }
+#else
+    juce::ignoreUnused (index);
+#endif
+    return stats;
+}
+
+void LayoutPlan::resetNodeStats ()
+{
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    for (int index=0; index < nodeStats.size(); ++index) {
+        nodeStats.set (index, LayoutNodeStats());
+    }
+#endif
+}
+
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+void LayoutPlan::setTraceRecorder (LayoutTraceRecorder* recorder)
+{
+    traceRecorder = recorder;
+}
+#endif
+
+void LayoutPlan::setIntegerDistribution (bool shouldDistributeIntegers)
+{
+    if (integerDistribution != shouldDistributeIntegers) {
+        integerDistribution = shouldDistributeIntegers;
+        // all sizes change, so the next solve starts from the root
+        solved = false;
+    }
+}
+
+bool LayoutPlan::isDistributingIntegers () const
+{
+    return integerDistribution;
+}
+
+void LayoutPlan::setLazyComponentOwner (juce::Component* owningComponent, Layout* layout, bool releaseCollapsed)
+{
+    lazyComponentOwner         = owningComponent;
+    lazyComponentLayout        = layout;
+    releaseCollapsedComponents = releaseCollapsed;
+}
+
+bool LayoutPlan::apply ()
+{
+    bool positionsChanged = false;
+
+    // store all results first, so components see a consistent state in their resized callbacks
+    changedItems.clearQuick();
+    for (int i=0; i < solvedItems.size(); ++i) {
+        const int index = solvedItems.getUnchecked (i);
+        juce::ReferenceCountedObjectPtr<LayoutItem::SharedLayoutData>& data = sharedData.getReference (index);
+        if (data == nullptr) {
+            data = LayoutItem::getOrCreateData (nodes.getReference (index));
+        }
+        data->itemBounds     = itemBounds.getUnchecked (index);
+        data->boundsAreFinal = boundsAreFinal.getUnchecked (index);
+
+        const juce::Rectangle<int> paddedBounds = getPaddedItemBounds (index);
+        if (data->listenerBounds != paddedBounds) {
+            data->listenerBounds = paddedBounds;
+            changedItems.add (index);
+        }
+
+        if (types.getUnchecked (index) == LayoutItem::SplitterItem) {
+            LayoutSplitter splitter (nodes.getReference (index));
+            const float position = relativePositions.getUnchecked (index);
+            // only write clamped positions back, so listeners of the state see real changes only
+            if (splitter.getRelativePosition() != position) {
+                splitter.setRelativePosition (position);
+                positionsChanged = true;
+            }
+        }
+    }
+
+    // move only components, whose bounds actually changed, to avoid needless resized and repaint calls
+    for (int i=0; i < solvedItems.size(); ++i) {
+        const int index = solvedItems.getUnchecked (i);
+        LayoutItem::SharedLayoutData* data = sharedData.getReference (index);
+        const juce::Rectangle<int> bounds = getComponentBounds (index);
+        juce::Component* c = data->getComponent();
+        if (data->createComponentLazily) {
+            if (c == nullptr && ! bounds.isEmpty()) {
+                c = LayoutItem::createOwnedComponent (nodes.getReference (index), lazyComponentOwner, lazyComponentLayout);
+            }
+            else if (c != nullptr && bounds.isEmpty() && releaseCollapsedComponents) {
+                if (lazyComponentLayout != nullptr) {
+                    lazyComponentLayout->removeComponentFromIndex (nodes.getReference (index), c);
+                }
+                data->ownedComponent = nullptr;
+                c = nullptr;
+            }
+        }
+        if (c != nullptr && c->getBounds() != bounds) {
+            c->setBounds (bounds);
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+            ++nodeStats.getReference (index).numSetBounds;
+#endif
+        }
+    }
+
+    // call only listeners of items, whose bounds really changed
+    for (int i=0; i < changedItems.size(); ++i) {
+        const int index = changedItems.getUnchecked (i);
+        LayoutItem::SharedLayoutData* data = sharedData.getReference (index);
+        if (notifyListeners.getUnchecked (index) && ! data->layoutItemListeners.isEmpty()) {
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+            nodeStats.getReference (index).numListenerCalls += data->layoutItemListeners.size();
+            const LayoutTraceRecorder::ScopedSpan listenerSpan (traceRecorder, nodePaths [index], "listeners");
+#endif
+            data->callListenersCallback (nodes.getReference (index), data->listenerBounds);
+        }
+    }
+
+    if (! changedItems.isEmpty() && ! nodes.isEmpty()) {
+        LayoutItem::SharedLayoutData* rootData = LayoutItem::getSharedData (nodes.getReference (0));
+        if (rootData != nullptr && ! rootData->layoutItemListeners.isEmpty()) {
+            juce::Array<juce::ValueTree> changedNodes;
+            changedNodes.ensureStorageAllocated (changedItems.size());
+            for (int i=0; i < changedItems.size(); ++i) {
+                changedNodes.add (nodes.getReference (changedItems.getUnchecked (i)));
+            }
+            rootData->layoutItemListeners.call (&LayoutItem::Listener::layoutItemsChanged, nodes.getReference (0), changedNodes);
+        }
+    }
+    // the results are with the components now, the next solve collects new ones
+    clearSolvedItems();
+    return positionsChanged;
+}
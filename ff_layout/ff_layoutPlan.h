@@ -0,0 +1,497 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutPlan.h
+    Created: 16 Oct 2026 10:12:31am
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+#include "ff_layoutItem.h"
+#include "ff_layoutDistribution.h"
+
+//==============================================================================
+/**
+ A LayoutPlan is a flat copy of a layout tree, which is used to solve the geometry
+ without looking up properties in the ValueTree over and over again.
+
+ Compiling walks the tree once and stores the structure and every property the
+ solver needs in plain arrays, one entry per item. The root node has the index 0,
+ the children of each sub layout are stored contiguously.
+
+ Solving works on these arrays only, the results are transferred to the items
+ and their components in a separate step by calling apply().
+
+ Without calling apply, the plan can be used as a solver, that doesn't touch
+ any component, e.g. to compute a layout for custom rendering or in a test:
+
+ \code{.cpp}
+ LayoutPlan plan;
+ plan.compile (tree);
+ plan.solve (juce::Rectangle<int> (0, 0, 800, 600));
+ for (int i=1; i < plan.getNumItems(); ++i) {
+     drawItem (plan.getNode (i), plan.getComponentBounds (i));
+ }
+ \endcode
+
+ Compiling only reads the tree, it must not be changed at the same time. Once
+ compiled, solving works on the plan alone, so the plan can be moved to any thread
+ and solved there.
+
+ @see Layout::updateGeometry
+ */
+class LayoutPlan
+{
+public:
+    LayoutPlan ();
+    ~LayoutPlan ();
+
+    LayoutPlan (const LayoutPlan&) = default;
+    LayoutPlan& operator= (const LayoutPlan&) = default;
+
+    /** Moving hands the compiled and solved arrays over without copying them */
+    LayoutPlan (LayoutPlan&&) = default;
+    LayoutPlan& operator= (LayoutPlan&&) = default;
+
+    /**
+     Read the structure and all properties relevant for the geometry from the
+     tree below root. A previously compiled tree is discarded.
+     If attachToItems is set, each item with SharedLayoutData remembers its index in this
+     plan, so indexOf finds it without searching, and the results of items without it are
+     kept in the plan instead of adding data to the tree. Otherwise apply creates the data
+     in the tree to store the results. Only one plan per tree should attach.
+     */
+    void compile (const juce::ValueTree& root, bool attachToItems=false);
+
+    /** Discards the compiled tree, e.g. because the structure has changed */
+    void clear ();
+
+    /** Returns true, if compile was called after the last clear */
+    bool isCompiled () const;
+
+    /** Returns the number of items including the root node */
+    int getNumItems () const;
+
+    /** Returns the ValueTree node of the item at index */
+    juce::ValueTree getNode (int index) const;
+
+    /** Returns the index of node in the plan or -1, if it is not part of the plan */
+    int indexOf (const juce::ValueTree& node) const;
+
+    /**
+     Uses the SharedLayoutData of node after it was created in the tree, e.g. because a
+     listener or a component was added, instead of the data the plan kept for it.
+     */
+    void updateSharedData (const juce::ValueTree& node);
+
+    /**
+     Reads the properties of node again after they were changed. The cached stretch and
+     size limits of the sub layouts containing node are invalidated and the sub layout
+     holding node is marked to be solved again by solveChanges.
+     If only the relativePosition of a splitter changed, solveChanges computes only the
+     items next to that splitter. Pass the changed property to allow that.
+     Returns false, if the node is not part of the plan, so it needs to be compiled again.
+     */
+    bool updateProperties (const juce::ValueTree& node, const juce::Identifier& property=juce::Identifier());
+
+    /**
+     Returns the bounds computed by the last solve for the item at index. The root
+     item at index 0 is not computed, it gets the bounds given to solve.
+     */
+    juce::Rectangle<int> getItemBounds (int index) const;
+
+    /**
+     Returns the bounds the last apply wrote to the item at index. This reads only data,
+     that solving doesn't touch, so it can be called while the plan is solved on another thread.
+     */
+    juce::Rectangle<int> getAppliedBounds (int index) const;
+
+    /** Returns the bounds computed by the last solve for node or an empty rectangle, if it is not part of the plan */
+    juce::Rectangle<int> getItemBounds (const juce::ValueTree& node) const;
+
+    /**
+     Returns the bounds a component of the item at index is set to. This is the item's
+     bounds reduced by the padding, only sub layouts and splitters use the full bounds.
+     */
+    juce::Rectangle<int> getComponentBounds (int index) const;
+
+    /** Returns the position of the splitter at index after it was clamped by the last solve */
+    float getRelativePosition (int index) const;
+
+    /**
+     Computes the geometry of the whole tree. The bounds are the space available for
+     the children of the root node, i.e. the padding of the root is already removed.
+     */
+    void solve (juce::Rectangle<int> bounds);
+
+    /**
+     Computes only the parts of the tree, that were changed since the last solve. If the
+     bounds differ from the last solve or the plan was not solved yet, the whole tree is
+     computed. Items computed by an earlier solve, that was not applied, are kept for
+     the next apply. Returns true, if any item was computed and needs to be applied.
+     */
+    bool solveChanges (juce::Rectangle<int> bounds);
+
+    /** Returns true, if properties were changed since the last solve */
+    bool hasChanges () const;
+
+    /** Returns the bounds of the last solve */
+    juce::Rectangle<int> getSolvedBounds () const;
+
+    /** Returns true, if solveChanges with these bounds would compute anything */
+    bool needsSolve (juce::Rectangle<int> bounds) const;
+
+    /**
+     The results of a solve, which can be stored and restored later, as long as
+     the plan was not compiled again and no property changed in the meantime.
+     */
+    struct Solution
+    {
+        juce::Rectangle<int>                bounds;
+        juce::Array<juce::Rectangle<int> >  itemBounds;
+        juce::Array<bool>                   boundsAreFinal;
+        juce::Array<bool>                   notifyListeners;
+        juce::Array<float>                  relativePositions;
+    };
+
+    /** Copies the results of the last solve into solution */
+    void getSolution (Solution& solution) const;
+
+    /**
+     Sets the results from a stored solution, as if it was just solved. The
+     following apply transfers all items.
+     */
+    void restoreSolution (const Solution& solution);
+
+    /**
+     Computes the geometry of the children from start to end of the sub layout at index.
+     The distribution respects all size limits after a single call, so there is no need
+     to solve again to let it settle.
+     Returns the number of pixels the items would need in addition to fit.
+     */
+    int solve (int index, juce::Rectangle<int> bounds, int start, int end);
+
+    /**
+     Transfers the results of the last solve to the items and calls setBounds on
+     the components of the computed items, if their bounds changed. The listeners
+     of the items, whose bounds changed, are called after all components were moved.
+     Finally the listeners of the root get one layoutItemsChanged call with all of them.
+     Returns true, if a splitter position had to be clamped and was written to the state.
+     */
+    bool apply ();
+
+    /**
+     Sets the component and layout, that components created lazily by apply are added to.
+     If releaseCollapsed is set, these components are deleted again, once their item gets
+     empty bounds. @see Layout::setLazyComponentCreation
+     */
+    void setLazyComponentOwner (juce::Component* owningComponent, Layout* layout, bool releaseCollapsed);
+
+    /**
+     If set, the children of sub layouts get whole pixel sizes, that add up exactly to the
+     size of the sub layout. The pixels left over by rounding down go to the items with the
+     largest remainders, so the items start at integer positions and a resize moves only
+     the items, whose share changed by a whole pixel. The next solve solves all items.
+     */
+    void setIntegerDistribution (bool shouldDistributeIntegers);
+
+    /** Returns true, if the sizes are distributed as whole pixels */
+    bool isDistributingIntegers () const;
+
+    /**
+     Sets the area in the coordinates of the root, that is currently visible. Virtual sub
+     layouts solve only the items inside that area. The virtual sub layouts, whose visible
+     items change, are marked to be solved again by solveChanges.
+     An empty area, which is the default, makes all items visible.
+     */
+    void setVisibleArea (juce::Rectangle<int> area);
+
+    /** Returns the area set by setVisibleArea */
+    juce::Rectangle<int> getVisibleArea () const;
+
+    /** Returns true, if any sub layout has the \p virtual property set */
+    bool hasVirtualItems () const;
+
+    /**
+     Returns the size of all children of the virtual sub layout at index in its direction,
+     computed from the sizes of the items without solving them. Returns 0, if the sub
+     layout is not virtual.
+     */
+    int getVirtualContentSize (int index);
+
+    /**
+     Returns the counters collected for the item at index since it was compiled. The realize
+     counters are kept by the Layout. All counters are zero, unless the module is compiled
+     with FF_LAYOUT_ENABLE_INSTRUMENTATION.
+     */
+    LayoutNodeStats getNodeStats (int index) const;
+
+    /** Sets the counters of all items back to zero */
+    void resetNodeStats ();
+
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    /**
+     Sets the recorder, that gets a span for each solved sub layout and each item, whose
+     listeners are called by apply. Set it to nullptr to stop recording.
+     */
+    void setTraceRecorder (LayoutTraceRecorder* recorder);
+#endif
+
+private:
+    void readProperties (int index);
+
+    /** A row or column of a grid layout */
+    struct GridTrack
+    {
+        float   stretch;
+        int     minSize;
+        int     maxSize;
+        int     start;
+        int     size;
+        float   flexSize;
+        bool    frozen;
+    };
+
+    /** The cell an item covers in a grid layout */
+    struct GridCell
+    {
+        int     column;
+        int     row;
+        int     columnSpan;
+        int     rowSpan;
+    };
+
+    static void parseGridTracks (const juce::String& text, juce::Array<GridTrack>& tracks);
+
+    /** Reads the tracks of the grid at index and assigns the cells of its children */
+    void placeGridCells (int index);
+
+    class GridTracks;
+
+    static void distributeGridTracks (juce::Array<GridTrack>& tracks, int start, int length);
+
+    void solveGrid (int index, juce::Rectangle<int> bounds);
+
+    bool isGrid (int index) const;
+
+    /** A line of a flow layout */
+    struct FlowLine
+    {
+        int     first;
+        int     y;
+        int     height;
+    };
+
+    /** The line breaks of a flow layout, kept until the bounds or a child change */
+    struct FlowState
+    {
+        juce::Rectangle<int>    bounds;
+        int                     numValid;
+        int                     bottom;
+        juce::Array<FlowLine>   lines;
+        juce::Array<int>        lineOfChild;
+    };
+
+    void getFlowItemSize (int index, int availableWidth, int& w, int& h) const;
+
+    int solveFlow (int index, juce::Rectangle<int> bounds);
+
+    /** Discards the line breaks of the flow at index from the line of the child at offset on */
+    void invalidateFlow (int index, int offset=0);
+
+    bool isFlow (int index) const;
+
+    bool isVirtual (int index) const;
+
+    int getVirtualItemSize (int index, bool vertical) const;
+
+    /** Returns the range of children of the virtual sub layout at index, that intersect the visible area */
+    void getVisibleChildren (int index, juce::Rectangle<int> bounds, int& start, int& end) const;
+
+    int solveVirtual (int index, juce::Rectangle<int> bounds);
+
+    void solveNode (int index, juce::Rectangle<int> bounds, bool onlyMovedSplitters=false);
+
+    enum DirtyState
+    {
+        Clean = 0,
+        SplittersMoved,
+        Changed
+    };
+
+    void markDirty (int index, DirtyState state);
+
+    /** Returns true, if the property can change the stretch a sub layout cummulates from its children */
+    static bool affectsImplicitStretch (const juce::Identifier& property);
+
+    /** Returns the highest ancestor, whose distribution depends on the stretch of the children of index */
+    int getHighestImplicitStretchAncestor (int index) const;
+
+    void solveChild (int index);
+
+    /** Adds index to the items to apply, unless it is already listed */
+    void addSolvedItem (int index);
+
+    void clearSolvedItems ();
+
+    class FlexibleChildren;
+
+    /**
+     Computes the sizes of the children from start to end in the direction of the sub layout,
+     so that no item violates its size limits. Returns the pixels the items need in addition.
+     */
+    int resolveFlexibleSizes (int index, float space, int start, int end, bool vertical);
+
+    /** Rounds the resolved sizes of the children from start to end using the largest remainder */
+    void distributeIntegerSizes (int index, int start, int end);
+
+    void clampSplitterPosition (int index, float minPosition, float maxPosition);
+
+    void getStretch (int index, float& w, float& h, int start=0, int end=-1);
+
+    /** Returns the stretch of a child as seen by its parent, reading the cached total of a sub layout */
+    void getTotalStretch (int index, float& w, float& h);
+
+    void getSizeLimits (int index, int& minW, int& maxW, int& minH, int& maxH, int start, int end) const;
+
+    void updateAggregates (int index);
+
+    void invalidateAggregates (int index);
+
+    void constrainBounds (int index, juce::Rectangle<int>& bounds, bool& changedWidth, bool& changedHeight, bool preferVertical) const;
+
+    juce::Rectangle<int> getPaddedItemBounds (int index) const;
+
+    bool isHorizontal (int index) const;
+
+    bool isVertical (int index) const;
+
+    static LayoutItem::ItemType getItemType (const juce::Identifier& type);
+
+    bool                                compiled;
+    bool                                solved;
+    juce::Rectangle<int>                solvedBounds;
+
+    // structure
+    juce::Array<juce::ValueTree>        nodes;
+    juce::Array<juce::ReferenceCountedObjectPtr<LayoutItem::SharedLayoutData> > sharedData;
+    juce::Array<int>                    parents;
+    juce::Array<int>                    firstChildren;
+    juce::Array<int>                    numChildren;
+
+    // properties
+    juce::Array<LayoutItem::ItemType>   types;
+    juce::Array<LayoutItem::Orientation> orientations;
+    juce::Array<float>                  stretchX;
+    juce::Array<float>                  stretchY;
+    juce::Array<int>                    minWidths;
+    juce::Array<int>                    maxWidths;
+    juce::Array<int>                    minHeights;
+    juce::Array<int>                    maxHeights;
+    juce::Array<float>                  aspectRatios;
+    juce::Array<int>                    paddingTops;
+    juce::Array<int>                    paddingLefts;
+    juce::Array<int>                    paddingRights;
+    juce::Array<int>                    paddingBottoms;
+    juce::Array<int>                    overlays;
+    juce::Array<float>                  overlayWidths;
+    juce::Array<float>                  overlayHeights;
+    juce::Array<int>                    overlayJustifications;
+    juce::Array<float>                  relativePositions;
+
+    // tracks of grid layouts, empty for all other items
+    juce::Array<juce::Array<GridTrack> > gridColumns;
+    juce::Array<juce::Array<GridTrack> > gridRows;
+    // the cell of each item inside a grid layout
+    juce::Array<GridCell>               gridCells;
+    // cached line breaks of flow layouts
+    juce::Array<FlowState>              flowStates;
+    // virtual sub layouts solve only the visible children
+    juce::Array<bool>                   virtualLists;
+    bool                                containsVirtualLists;
+    juce::Array<int>                    visibleStarts;
+    juce::Array<int>                    visibleEnds;
+    juce::Rectangle<int>                visibleArea;
+
+    // aggregates of the children, computed when solving and cached until a property changes
+    juce::Array<bool>                   aggregatesValid;
+    juce::Array<float>                  totalStretchX;
+    juce::Array<float>                  totalStretchY;
+    // minimum sizes of each item together with all following siblings
+    juce::Array<int>                    remainingMinWidths;
+    juce::Array<int>                    remainingMinHeights;
+    // start of each child of a virtual sub layout, the last entry is the total size
+    juce::Array<juce::Array<int> >      virtualOffsets;
+
+    // sub layouts, that need to be solved again
+    juce::Array<DirtyState>             dirty;
+    juce::Array<bool>                   movedSplitters;
+    int                                 numDirty;
+
+    // results
+    juce::Array<juce::Rectangle<int> >  itemBounds;
+    juce::Array<bool>                   boundsAreFinal;
+    juce::Array<bool>                   notifyListeners;
+    // items computed since the last apply, each listed once
+    juce::Array<int>                    solvedItems;
+    juce::Array<bool>                   isSolvedItem;
+    // sizes in the direction of the sub layout while distributing
+    juce::Array<float>                  flexSizes;
+    juce::Array<int>                    remainderOrder;
+    // items, whose bounds changed in the last apply
+    juce::Array<int>                    changedItems;
+
+    // owner of components, that are created when their item gets bounds
+    juce::Component*                    lazyComponentOwner;
+    Layout*                             lazyComponentLayout;
+    bool                                releaseCollapsedComponents;
+
+    bool                                integerDistribution;
+
+#if FF_LAYOUT_ENABLE_INSTRUMENTATION
+    class ScopedSolveTimer;
+
+    juce::Array<LayoutNodeStats>        nodeStats;
+    // names for the trace, built at compile, so a background solve doesn't touch the ValueTree
+    juce::StringArray                   nodePaths;
+    // time spent in the children of the item, that is currently solved
+    juce::int64                         childTicks;
+
+    LayoutTraceRecorder*                traceRecorder;
+#endif
+
+    JUCE_LEAK_DETECTOR (LayoutPlan)
+};
@@ -0,0 +1,703 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutStatic.h
+    Created: 16 Oct 2026 5:21:44pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+#include "ff_layoutItem.h"
+#include "ff_layoutDistribution.h"
+
+//==============================================================================
+/**
+ Layouts with a structure, that is fixed at compile time.
+
+ The structure is described by nesting the item types, the same items
+ LayoutItem::makeSubLayout, makeChildComponent, makeChildSpacer and
+ makeChildSplitter create at runtime. A StaticLayout::Solver for that description
+ keeps the properties and results in arrays sized by the compiler, so it doesn't
+ use a ValueTree, Identifiers or any heap allocation. This makes it suitable for
+ small layouts, that are instantiated many times:
+
+ \code{.cpp}
+ typedef StaticLayout::SubLayout<LayoutItem::TopDown,
+             StaticLayout::Component,
+             StaticLayout::SubLayout<LayoutItem::LeftToRight,
+                 StaticLayout::Component,
+                 StaticLayout::Spacer,
+                 StaticLayout::Component>,
+             StaticLayout::Component> VoiceStripLayout;
+
+ class VoiceStrip : public juce::Component
+ {
+ public:
+     VoiceStrip ()
+     {
+         layout.getItem (1).setComponent (&title).setFixedHeight (20);
+         layout.getItem (3).setComponent (&mute);
+         layout.getItem (4).setStretch (0.5, 1.0);
+         layout.getItem (5).setComponent (&solo);
+         layout.getItem (6).setComponent (&level).setStretch (1.0, 4.0);
+     }
+     void resized () override
+     {
+         layout.updateGeometry (getLocalBounds());
+     }
+ private:
+     StaticLayout::Solver<VoiceStripLayout> layout;
+     ...
+ };
+ \endcode
+
+ Items are numbered in the order they appear in the description, the root is 0.
+ The geometry is computed by the same rules a LayoutPlan uses.
+ */
+namespace StaticLayout
+{
+    //==============================================================================
+    /** The properties of one item, the setters mirror the ones of LayoutItem */
+    class Properties
+    {
+    public:
+        Properties ()
+        : component (nullptr),
+          stretchX (1.0f), stretchY (1.0f),
+          minWidth (-1), maxWidth (-1), minHeight (-1), maxHeight (-1),
+          aspectRatio (0.0f),
+          paddingTop (0), paddingLeft (0), paddingRight (0), paddingBottom (0),
+          overlay (0), overlayWidth (1.0f), overlayHeight (1.0f),
+          overlayJustification (juce::Justification::centred),
+          relativePosition (0.5f)
+        {}
+
+        /** Sets the component, that is moved to the bounds of this item */
+        Properties& setComponent (juce::Component* c)                 { component = c; return *this; }
+        /** Set the stretch factors. On sub layouts a negative value uses the sum of the children */
+        Properties& setStretch (float w, float h)                     { stretchX = w; stretchY = h; return *this; }
+        Properties& setMinimumWidth (int w)                           { minWidth = w; return *this; }
+        Properties& setMaximumWidth (int w)                           { maxWidth = w; return *this; }
+        Properties& setMinimumHeight (int h)                          { minHeight = h; return *this; }
+        Properties& setMaximumHeight (int h)                          { maxHeight = h; return *this; }
+        Properties& setFixedWidth (int w)                             { minWidth = maxWidth = w; return *this; }
+        Properties& setFixedHeight (int h)                            { minHeight = maxHeight = h; return *this; }
+        Properties& setFixedSize (int w, int h)                       { return setFixedWidth (w).setFixedHeight (h); }
+        Properties& setAspectRatio (float ratio)                      { aspectRatio = ratio; return *this; }
+        Properties& setPaddingTop (int p)                             { paddingTop = p; return *this; }
+        Properties& setPaddingLeft (int p)                            { paddingLeft = p; return *this; }
+        Properties& setPaddingRight (int p)                           { paddingRight = p; return *this; }
+        Properties& setPaddingBottom (int p)                          { paddingBottom = p; return *this; }
+        Properties& setPadding (int p)                                { paddingTop = paddingLeft = paddingRight = paddingBottom = p; return *this; }
+        /** 1 overlays the previous item, 2 overlays the whole sub layout @see LayoutItem::setIsOverlay */
+        Properties& setIsOverlay (int o)                              { overlay = o; return *this; }
+        Properties& setOverlayWidth (float w)                         { overlayWidth = w; return *this; }
+        Properties& setOverlayHeight (float h)                        { overlayHeight = h; return *this; }
+        Properties& setOverlayJustification (int j)                   { overlayJustification = j; return *this; }
+        /** Sets the position of a splitter, it is clamped to the size limits when solving */
+        Properties& setRelativePosition (float position)              { relativePosition = position; return *this; }
+
+        juce::Component* component;
+        float stretchX;
+        float stretchY;
+        int   minWidth;
+        int   maxWidth;
+        int   minHeight;
+        int   maxHeight;
+        float aspectRatio;
+        int   paddingTop;
+        int   paddingLeft;
+        int   paddingRight;
+        int   paddingBottom;
+        int   overlay;
+        float overlayWidth;
+        float overlayHeight;
+        int   overlayJustification;
+        float relativePosition;
+    };
+
+    //==============================================================================
+    /** The structure of a description, filled once for each description type */
+    template <int numItems>
+    struct Structure
+    {
+        LayoutItem::ItemType        types[numItems];
+        LayoutItem::Orientation     orientations[numItems];
+        int                         firstChildren[numItems];
+        int                         numChildren[numItems];
+        // the item indices of the children, the children of each sub layout are stored contiguously
+        int                         children[numItems];
+        int                         numSlots;
+    };
+
+    template <LayoutItem::ItemType itemType>
+    struct Leaf
+    {
+        enum { numItems = 1 };
+
+        template <typename StructureType>
+        static void describe (StructureType& s, int index)
+        {
+            s.types[index]         = itemType;
+            s.orientations[index]  = LayoutItem::Unknown;
+            s.firstChildren[index] = 0;
+            s.numChildren[index]   = 0;
+        }
+    };
+
+    /** An item, that places a component */
+    typedef Leaf<LayoutItem::ComponentItem> Component;
+    /** An empty item, that only takes space */
+    typedef Leaf<LayoutItem::SpacerItem>    Spacer;
+    /** A splitter between the items of a sub layout at Properties::relativePosition */
+    typedef Leaf<LayoutItem::SplitterItem>  Splitter;
+
+    template <typename... Items>
+    struct Children;
+
+    template <>
+    struct Children<>
+    {
+        enum { numItems = 0 };
+
+        template <typename StructureType>
+        static void describe (StructureType&, int, int) {}
+    };
+
+    template <typename First, typename... Rest>
+    struct Children<First, Rest...>
+    {
+        enum { numItems = First::numItems + Children<Rest...>::numItems };
+
+        template <typename StructureType>
+        static void describe (StructureType& s, int slot, int index)
+        {
+            s.children[slot] = index;
+            First::describe (s, index);
+            Children<Rest...>::describe (s, slot + 1, index + First::numItems);
+        }
+    };
+
+    /** A sub layout, that arranges the items in the given orientation */
+    template <LayoutItem::Orientation orientation, typename... Items>
+    struct SubLayout
+    {
+        enum { numItems = 1 + Children<Items...>::numItems };
+
+        template <typename StructureType>
+        static void describe (StructureType& s, int index)
+        {
+            s.types[index]         = LayoutItem::SubLayout;
+            s.orientations[index]  = orientation;
+            s.firstChildren[index] = s.numSlots;
+            s.numChildren[index]   = sizeof... (Items);
+            // reserve the slots before descending, so the children stay together
+            s.numSlots += sizeof... (Items);
+            Children<Items...>::describe (s, s.firstChildren[index], index + 1);
+        }
+    };
+
+    //==============================================================================
+    /**
+     Computes the geometry of a layout described by Root and sets the bounds of
+     the components of the items.
+     */
+    template <typename Root>
+    class Solver
+    {
+    public:
+        enum { numItems = Root::numItems };
+
+        Solver ()
+        : integerDistribution (false)
+        {
+            for (int i=0; i < numItems; ++i) {
+                boundsAreFinal[i]  = false;
+                positions[i]       = 0.5f;
+            }
+            // sub layouts cummulate the stretch of their children by default
+            for (int i=0; i < numItems; ++i) {
+                if (getStructure().types[i] == LayoutItem::SubLayout) {
+                    properties[i].setStretch (-1.0f, -1.0f);
+                }
+            }
+        }
+
+        /** Returns the properties of the item at index to be changed */
+        Properties& getItem (int index)
+        {
+            jassert (juce::isPositiveAndBelow (index, static_cast<int> (numItems)));
+            return properties[index];
+        }
+
+        /** Returns the properties of the item at index */
+        const Properties& getItem (int index) const
+        {
+            jassert (juce::isPositiveAndBelow (index, static_cast<int> (numItems)));
+            return properties[index];
+        }
+
+        /** Returns the type of the item at index */
+        LayoutItem::ItemType getItemType (int index) const
+        {
+            return getStructure().types[index];
+        }
+
+        /**
+         Computes the geometry inside bounds without moving any component. The padding of
+         the root item is applied to bounds.
+         */
+        void solve (juce::Rectangle<int> bounds)
+        {
+            itemBounds[0]     = bounds;
+            boundsAreFinal[0] = true;
+            solveNode (0, getPaddedItemBounds (0));
+        }
+
+        /** Computes the geometry and sets the bounds of all components, that changed */
+        void updateGeometry (juce::Rectangle<int> bounds)
+        {
+            solve (bounds);
+            for (int i=0; i < numItems; ++i) {
+                if (juce::Component* c = properties[i].component) {
+                    const juce::Rectangle<int> b = getComponentBounds (i);
+                    if (c->getBounds() != b) {
+                        c->setBounds (b);
+                    }
+                }
+            }
+        }
+
+        /** Returns the bounds computed for the item at index */
+        juce::Rectangle<int> getItemBounds (int index) const
+        {
+            return itemBounds[index];
+        }
+
+        /** Returns the bounds a component of the item at index is set to @see LayoutPlan::getComponentBounds */
+        juce::Rectangle<int> getComponentBounds (int index) const
+        {
+            const LayoutItem::ItemType type = getStructure().types[index];
+            if (type == LayoutItem::SubLayout || type == LayoutItem::SplitterItem) {
+                return itemBounds[index];
+            }
+            return getPaddedItemBounds (index);
+        }
+
+        /**
+         Rounds the sizes in the direction of each sub layout to whole pixels, so the items
+         don't jitter by a pixel when resizing @see LayoutPlan::setIntegerDistribution
+         */
+        void setIntegerDistribution (bool shouldDistributeIntegers)
+        {
+            integerDistribution = shouldDistributeIntegers;
+        }
+
+        /** Returns true, if the sizes are distributed as whole pixels */
+        bool isDistributingIntegers () const
+        {
+            return integerDistribution;
+        }
+
+        /** Returns the position of the splitter at index after it was clamped by the last solve */
+        float getRelativePosition (int index) const
+        {
+            return positions[index];
+        }
+
+    private:
+        typedef Structure<numItems> StructureType;
+
+        static const StructureType& getStructure ()
+        {
+            static const StructureType structure (createStructure());
+            return structure;
+        }
+
+        static StructureType createStructure ()
+        {
+            StructureType s;
+            s.numSlots = 0;
+            Root::describe (s, 0);
+            return s;
+        }
+
+        bool isHorizontal (int index) const
+        {
+            const LayoutItem::Orientation o = getStructure().orientations[index];
+            return o == LayoutItem::LeftToRight || o == LayoutItem::RightToLeft;
+        }
+
+        bool isVertical (int index) const
+        {
+            const LayoutItem::Orientation o = getStructure().orientations[index];
+            return o == LayoutItem::TopDown || o == LayoutItem::BottomUp;
+        }
+
+        juce::Rectangle<int> getPaddedItemBounds (int index) const
+        {
+            const Properties& p = properties[index];
+            const juce::Rectangle<int>& bounds = itemBounds[index];
+            return juce::Rectangle<int> (bounds.getX() + p.paddingLeft,
+                                         bounds.getY() + p.paddingTop,
+                                         bounds.getWidth()  - (p.paddingLeft + p.paddingRight),
+                                         bounds.getHeight() - (p.paddingTop  + p.paddingBottom));
+        }
+
+        void constrainBounds (int index, juce::Rectangle<int>& bounds, bool& changedWidth, bool& changedHeight, bool preferVertical) const
+        {
+            const Properties& p = properties[index];
+            LayoutItem::constrainBounds (bounds, changedWidth, changedHeight, preferVertical,
+                                         p.minWidth, p.maxWidth, p.minHeight, p.maxHeight, p.aspectRatio);
+        }
+
+        int getChild (int index, int i) const
+        {
+            const StructureType& s = getStructure();
+            return s.children[s.firstChildren[index] + i];
+        }
+
+        void getStretch (int index, float& w, float& h, int start=0, int end=numItems) const
+        {
+            const StructureType& s = getStructure();
+            const float sx = properties[index].stretchX;
+            const float sy = properties[index].stretchY;
+            if (s.types[index] != LayoutItem::SubLayout) {
+                w = sx;
+                h = sy;
+                return;
+            }
+
+            const bool horizontal = isHorizontal (index);
+            const bool vertical   = isVertical (index);
+
+            w = std::max (sx, 0.0f);
+            h = std::max (sy, 0.0f);
+
+            if (w > 0.0001 && h > 0.0001) {
+                return;
+            }
+
+            const int stop = std::min (end, s.numChildren[index]);
+            for (int i=start; i < stop; ++i) {
+                const int child = getChild (index, i);
+                if (properties[child].overlay < 1) {
+                    float x, y;
+                    getStretch (child, x, y);
+                    if (horizontal) {
+                        if (sx <= 0) w += x;
+                        if (sy <= 0) h = std::max (h, y);
+                    }
+                    else if (vertical) {
+                        if (sx <= 0) w = std::max (w, x);
+                        if (sy <= 0) h += y;
+                    }
+                    else {
+                        if (sx <= 0) w += x;
+                        if (sy <= 0) h += y;
+                    }
+                }
+            }
+
+            // no stretch in children defaults to 1.0
+            if (w <= 0.0) w = 1.0;
+            if (h <= 0.0) h = 1.0;
+        }
+
+        void getSizeLimits (int index, int& minW, int& maxW, int& minH, int& maxH, int start, int end) const
+        {
+            bool canConsumeWidth  = false;
+            bool canConsumeHeight = false;
+            const bool vertical   = isVertical (index);
+            const bool horizontal = isHorizontal (index);
+
+            const int stop = std::min (end, getStructure().numChildren[index]);
+            for (int i=start; i < stop && (vertical || horizontal); ++i) {
+                const Properties& c = properties[getChild (index, i)];
+                if (c.overlay >= 1) {
+                    continue;
+                }
+                if (vertical) {
+                    if (c.minWidth >= 0) minW = (minW < 0) ? c.minWidth : juce::jmax (minW, c.minWidth);
+                    if (c.maxWidth >= 0) maxW = (maxW < 0) ? c.maxWidth : juce::jmin (maxW, c.maxWidth);
+                    if (c.minHeight >= 0) minH = (minH < 0) ? c.minHeight : minH + c.minHeight;
+                    if (c.maxHeight >= 0) {
+                        maxH = (maxH < 0) ? c.maxHeight : maxH + c.maxHeight;
+                    }
+                    else {
+                        canConsumeHeight = true;
+                    }
+                }
+                else {
+                    if (c.minWidth >= 0) minW = (minW < 0) ? c.minWidth : minW + c.minWidth;
+                    if (c.maxWidth >= 0) {
+                        maxW = (maxW < 0) ? c.maxWidth : maxW + c.maxWidth;
+                    }
+                    else {
+                        canConsumeWidth = true;
+                    }
+                    if (c.minHeight >= 0) minH = (minH < 0) ? c.minHeight : juce::jmax (minH, c.minHeight);
+                    if (c.maxHeight >= 0) maxH = (maxH < 0) ? c.maxHeight : juce::jmin (maxH, c.maxHeight);
+                }
+            }
+            if (canConsumeWidth)  maxW = -1;
+            if (canConsumeHeight) maxH = -1;
+        }
+
+        void solveNode (int index, juce::Rectangle<int> bounds)
+        {
+            const StructureType& s = getStructure();
+            if (s.types[index] != LayoutItem::SubLayout) {
+                return;
+            }
+
+            const LayoutItem::Orientation orientation = s.orientations[index];
+            const int num = s.numChildren[index];
+
+            int last = 0;
+            juce::Rectangle<int> childBounds (bounds);
+            for (int i=0; i < num; ++i) {
+                const int child = getChild (index, i);
+                if (properties[child].overlay >= 1 || s.types[child] != LayoutItem::SplitterItem) {
+                    continue;
+                }
+
+                juce::Rectangle<int> splitterBounds (bounds);
+                int leftMinW = -1, leftMaxW = -1, leftMinH = -1, leftMaxH = -1;
+                getSizeLimits (index, leftMinW, leftMaxW, leftMinH, leftMaxH, last, i);
+                int rightMinW = -1, rightMaxW = -1, rightMinH = -1, rightMaxH = -1;
+                getSizeLimits (index, rightMinW, rightMaxW, rightMinH, rightMaxH, i, num);
+
+                positions[child] = properties[child].relativePosition;
+                float minPosition, maxPosition;
+                if (LayoutDistribution::getSplitterLimits (orientation, bounds, leftMinW, leftMinH, rightMinW, rightMinH, minPosition, maxPosition)) {
+                    positions[child] = LayoutDistribution::clampSplitterPosition (positions[child], minPosition, maxPosition);
+                }
+
+                if (orientation == LayoutItem::LeftToRight) {
+                    int right = childBounds.getX() + positions[child] * bounds.getWidth();
+                    solve (index, childBounds.withRight (right-1), last, i);
+                    splitterBounds.setX (right-1);
+                    splitterBounds.setWidth (3);
+                    childBounds.setLeft (right+1);
+                }
+                else if (orientation == LayoutItem::TopDown) {
+                    int bottom = childBounds.getY() + positions[child] * bounds.getHeight();
+                    solve (index, childBounds.withBottom (bottom), last, i);
+                    splitterBounds.setY (bottom-1);
+                    splitterBounds.setHeight (3);
+                    childBounds.setTop (bottom+1);
+                }
+                else if (orientation == LayoutItem::RightToLeft) {
+                    int left = childBounds.getX() + positions[child] * bounds.getWidth();
+                    solve (index, childBounds.withLeft (left), last, i);
+                    splitterBounds.setX (left-1);
+                    splitterBounds.setWidth (3);
+                    childBounds.setRight (left-1);
+                }
+                else if (orientation == LayoutItem::BottomUp) {
+                    int top = childBounds.getY() + positions[child] * bounds.getHeight();
+                    solve (index, childBounds.withTop (top), last, i);
+                    splitterBounds.setY (top-1);
+                    splitterBounds.setHeight (3);
+                    childBounds.setBottom (top-1);
+                }
+                itemBounds[child]     = splitterBounds;
+                boundsAreFinal[child] = true;
+
+                i++;
+                last = i;
+            }
+
+            // layout rest right of splitter, if any
+            solve (index, childBounds, last, num);
+        }
+
+        void placeChild (int child, juce::Rectangle<int> bounds)
+        {
+            itemBounds[child] = bounds;
+            solveNode (child, getPaddedItemBounds (child));
+        }
+
+        /** Lets LayoutDistribution work on the children of a sub layout, the slots are the child numbers */
+        class FlexibleChildren
+        {
+        public:
+            FlexibleChildren (Solver& solverToUse, int indexToUse, bool verticalToUse)
+              : solver (solverToUse),
+                index (indexToUse),
+                vertical (verticalToUse)
+            {
+            }
+
+            bool isFlexible (int slot) const            { return solver.properties[solver.getChild (index, slot)].overlay < 1; }
+            bool isFrozen (int slot) const              { return solver.boundsAreFinal[solver.getChild (index, slot)]; }
+            void freeze (int slot)                      { solver.boundsAreFinal[solver.getChild (index, slot)] = true; }
+            float getSize (int slot) const              { return solver.flexSizes[solver.getChild (index, slot)]; }
+            void setSize (int slot, float size)         { solver.flexSizes[solver.getChild (index, slot)] = size; }
+
+            float getStretch (int slot)
+            {
+                float sx, sy;
+                solver.getStretch (solver.getChild (index, slot), sx, sy);
+                return vertical ? sy : sx;
+            }
+
+            float clampToSizeLimits (int slot, float size) const
+            {
+                const Properties& p = solver.properties[solver.getChild (index, slot)];
+                return vertical ? LayoutDistribution::clampToSizeLimits (size, p.minHeight, p.maxHeight)
+                                : LayoutDistribution::clampToSizeLimits (size, p.minWidth,  p.maxWidth);
+            }
+
+        private:
+            Solver&     solver;
+            const int   index;
+            const bool  vertical;
+
+            JUCE_DECLARE_NON_COPYABLE (FlexibleChildren)
+        };
+
+        void solve (int index, juce::Rectangle<int> bounds, int start, int end)
+        {
+            const StructureType& s = getStructure();
+            const LayoutItem::Orientation orientation = s.orientations[index];
+            const bool vertical = isVertical (index);
+            if (! vertical && ! isHorizontal (index)) {
+                return;
+            }
+
+            float cummulatedX, cummulatedY;
+            getStretch (index, cummulatedX, cummulatedY, start, end);
+            float availableWidth  = bounds.getWidth();
+            float availableHeight = bounds.getHeight();
+            const int stop = juce::jmin (s.numChildren[index], end);
+
+            // first pass: constrain the items and take the fixed ones out of the distribution
+            for (int i=start; i < stop; ++i) {
+                const int child = getChild (index, i);
+                if (properties[child].overlay >= 1) {
+                    continue;
+                }
+                float sx, sy;
+                getStretch (child, sx, sy);
+                juce::Rectangle<int> childBounds;
+                if (vertical) {
+                    childBounds = juce::Rectangle<int> (bounds.getX(), bounds.getY(), bounds.getWidth(), bounds.getHeight() * sy / cummulatedY);
+                }
+                else {
+                    childBounds = juce::Rectangle<int> (bounds.getX(), bounds.getY(), bounds.getWidth() * sx / cummulatedX, bounds.getHeight());
+                }
+                bool changedWidth, changedHeight;
+                constrainBounds (child, childBounds, changedWidth, changedHeight, vertical);
+                itemBounds[child] = childBounds;
+                const bool changedMain  = vertical ? changedHeight : changedWidth;
+                const bool changedCross = vertical ? changedWidth  : changedHeight;
+                // the aspect ratio fixes the size, the size limits are resolved together below
+                boundsAreFinal[child] = changedMain && properties[child].aspectRatio > 0.001;
+                flexSizes[child] = vertical ? childBounds.getHeight() : childBounds.getWidth();
+                if (changedCross) {
+                    if (vertical) {
+                        availableWidth = std::max (bounds.getWidth(), childBounds.getWidth());
+                    }
+                    else {
+                        availableHeight = std::max (bounds.getHeight(), childBounds.getHeight());
+                    }
+                }
+            }
+
+            FlexibleChildren children (*this, index, vertical);
+            LayoutDistribution::resolveFlexibleSizes (children, vertical ? bounds.getHeight() : bounds.getWidth(), start, stop);
+            if (integerDistribution) {
+                LayoutDistribution::distributeIntegerSizes (children, start, stop, remainderOrder);
+            }
+
+            // second pass: place the items one after the other
+            const bool reversed = orientation == LayoutItem::BottomUp || orientation == LayoutItem::RightToLeft;
+            float pos = vertical ? bounds.getY() : bounds.getX();
+            if (reversed) {
+                pos += vertical ? bounds.getHeight() : bounds.getWidth();
+            }
+            for (int i=start; i < stop; ++i) {
+                const int child = getChild (index, i);
+                const int overlay = properties[child].overlay;
+                if (overlay < 1) {
+                    const float size = flexSizes[child];
+                    if (reversed) {
+                        pos -= size;
+                    }
+                    if (vertical) {
+                        placeChild (child, juce::Rectangle<int> (bounds.getX(), pos, availableWidth, size));
+                    }
+                    else {
+                        placeChild (child, juce::Rectangle<int> (pos, bounds.getY(), size, availableHeight));
+                    }
+                    if (! reversed) {
+                        pos += size;
+                    }
+                }
+                else {
+                    // overlay other item
+                    juce::Rectangle<int> overlayTarget;
+                    if (overlay == 1 && i > start) {
+                        overlayTarget = itemBounds[getChild (index, i - 1)];
+                    }
+                    else if (overlay == 2) {
+                        overlayTarget = bounds;
+                    }
+                    const Properties& p = properties[child];
+                    juce::Rectangle<int> overlayBounds (0, 0,
+                                                        p.overlayWidth  * overlayTarget.getWidth(),
+                                                        p.overlayHeight * overlayTarget.getHeight());
+                    bool changedWidth, changedHeight;
+                    constrainBounds (child, overlayBounds, changedWidth, changedHeight, true);
+                    juce::Justification j (p.overlayJustification);
+                    placeChild (child, j.appliedToRectangle (overlayBounds, overlayTarget));
+                }
+            }
+        }
+
+        Properties              properties[numItems];
+        juce::Rectangle<int>    itemBounds[numItems];
+        bool                    boundsAreFinal[numItems];
+        float                   flexSizes[numItems];
+        float                   positions[numItems];
+        int                     remainderOrder[numItems];
+        bool                    integerDistribution;
+
+        JUCE_DECLARE_NON_COPYABLE (Solver)
+    };
+}
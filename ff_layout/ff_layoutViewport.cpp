@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutViewport.cpp
+    Created: 16 Oct 2026 7:48:03pm
+
+  ==============================================================================
+*/
+
+
+#include "ff_layout.h"
+
+LayoutViewportConnector::LayoutViewportConnector (Layout& layout_, juce::Viewport& viewport_)
+: layout (layout_),
+  viewport (&viewport_),
+  isUpdating (false)
+{
+    viewport_.addComponentListener (this);
+    update();
+}
+
+LayoutViewportConnector::~LayoutViewportConnector ()
+{
+    if (viewedComponent) {
+        viewedComponent->removeComponentListener (this);
+    }
+    if (viewport) {
+        viewport->removeComponentListener (this);
+    }
+}
+
+void LayoutViewportConnector::updateViewedComponent ()
+{
+    juce::Component* content = viewport ? viewport->getViewedComponent() : nullptr;
+    if (content != viewedComponent.getComponent()) {
+        if (viewedComponent) {
+            viewedComponent->removeComponentListener (this);
+        }
+        viewedComponent = content;
+        if (content) {
+            content->addComponentListener (this);
+        }
+    }
+}
+
+void LayoutViewportConnector::update ()
+{
+    if (isUpdating || viewport == nullptr) {
+        return;
+    }
+    const juce::ScopedValueSetter<bool> updating (isUpdating, true);
+
+    updateViewedComponent();
+    if (viewedComponent) {
+        const int size = layout.getVirtualContentSize();
+        if (size > 0) {
+            // the list fills the view across its direction
+            if (LayoutItem (layout.state).isHorizontal()) {
+                viewedComponent->setSize (size, viewport->getMaximumVisibleHeight());
+            }
+            else {
+                viewedComponent->setSize (viewport->getMaximumVisibleWidth(), size);
+            }
+        }
+    }
+    layout.setVisibleArea (viewport->getViewArea());
+}
+
+void LayoutViewportConnector::componentMovedOrResized (juce::Component& component, bool wasMoved, bool wasResized)
+{
+    if (viewport == nullptr) {
+        return;
+    }
+    if (&component == viewport.getComponent()) {
+        if (wasResized) {
+            update();
+        }
+    }
+    else if (! isUpdating) {
+        // scrolling moves the viewed component
+        layout.setVisibleArea (viewport->getViewArea());
+    }
+}
+
+void LayoutViewportConnector::componentBeingDeleted (juce::Component& component)
+{
+    component.removeComponentListener (this);
+}
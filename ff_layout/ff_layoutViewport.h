@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+  Copyright (c) 2016 - 2017, Daniel Walz
+  All rights reserved.
+
+  Redistribution and use in source and binary forms, with or without modification,
+  are permitted provided that the following conditions are met:
+
+  1. Redistributions of source code must retain the above copyright notice, this
+     list of conditions and the following disclaimer.
+
+  2. Redistributions in binary form must reproduce the above copyright notice,
+     this list of conditions and the following disclaimer in the documentation
+     and/or other materials provided with the distribution.
+
+  3. Neither the name of the copyright holder nor the names of its contributors
+     may be used to endorse or promote products derived from this software without
+     specific prior written permission.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+  ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+  WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+  IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+  INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+  DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+  OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+  OF THE POSSIBILITY OF SUCH DAMAGE.
+
+  ==============================================================================
+
+    ff_layoutViewport.h
+    Created: 16 Oct 2026 7:48:03pm
+
+  ==============================================================================
+*/
+
+#pragma once
+
+
+#include "ff_layoutCore.h"
+
+//==============================================================================
+/**
+ Connects a Layout to the juce::Viewport, that shows its owning component. The
+ owning component is sized to hold all items of a \p virtual root layout and the
+ view area is set as visible area, whenever the viewport is scrolled or resized.
+ So only the items in view are solved, positioned and, with lazy component
+ creation, realized:
+
+ \code{.cpp}
+ PresetList ()                       // the viewed component of presetViewport
+ : layout (BinaryData::presets_xml, BinaryData::presets_xmlSize, this),
+   connector (layout, presetViewport)
+ {
+ }
+ void resized () override
+ {
+     layout.updateGeometry();
+ }
+ \endcode
+
+ Call update after items were added or removed, so the size is adapted.
+ @see Layout::setVisibleArea, Layout::setLazyComponentCreation
+ */
+class LayoutViewportConnector : private juce::ComponentListener
+{
+public:
+    LayoutViewportConnector (Layout& layout, juce::Viewport& viewport);
+
+    ~LayoutViewportConnector ();
+
+    /** Sets the size of the viewed component to the content of the layout and the visible area */
+    void update ();
+
+private:
+    /** @internal */
+    void componentMovedOrResized (juce::Component& component, bool wasMoved, bool wasResized) override;
+
+    /** @internal */
+    void componentBeingDeleted (juce::Component& component) override;
+
+    /** Follows a component set to the viewport later */
+    void updateViewedComponent ();
+
+    Layout&                                             layout;
+    juce::Component::SafePointer<juce::Viewport>        viewport;
+    juce::Component::SafePointer<juce::Component>       viewedComponent;
+    bool                                                isUpdating;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LayoutViewportConnector)
+};